@@ -0,0 +1,115 @@
+#include "bench.h"
+
+#include <future>
+#include <string>
+#include <vector>
+
+#include <SDL2/SDL_image.h>
+
+#include "sdlpp/archive.h"
+#include "sdlpp/assetloader.h"
+#include "sdlpp/error.h"
+#include "sdlpp/pixel.h"
+#include "sdlpp/surface.h"
+#include "sdlpp/video.h"
+
+namespace Bench
+{
+namespace
+{
+constexpr int imageCount = 64;
+constexpr SDL::Size imageSize{256, 256};
+
+// PNGs with some structure, so that they do not compress to nothing
+std::vector<std::filesystem::path> makeImages(std::filesystem::path const& dir)
+{
+	std::vector<std::filesystem::path> paths;
+	for (int i = 0; i < imageCount; ++i)
+	{
+		SDL::Surface s{imageSize};
+		for (int y = 0; y < imageSize.h; y += 8)
+		{
+			for (int x = 0; x < imageSize.w; x += 8)
+			{
+				auto v = static_cast<std::uint8_t>((x * 7 + y * 13 + i * 31) & 0xFF);
+				s.fillRect({{x, y}, {8, 8}}, SDL::Color{v, static_cast<std::uint8_t>(255 - v), static_cast<std::uint8_t>(v ^ 0x5A)});
+			}
+		}
+		auto& path = paths.emplace_back(dir / ("image" + std::to_string(i) + ".png"));
+		if (IMG_SavePNG(s.get(), path.string().c_str()) < 0)
+		{
+			throw SDL::Error{IMG_GetError()};
+		}
+	}
+	return paths;
+}
+}
+
+void assetBenchmarks(Runner& runner, Context& context)
+{
+	if (not runner.wants("assets/"))
+	{
+		return;
+	}
+
+	auto& renderer = context.renderer;
+	auto paths = makeImages(context.scratch);
+
+	runner.run("assets/load/serial", [&]
+	{
+		for (auto const& path: paths)
+		{
+			SDL::Surface s{path};
+			keep(s.getTexture(renderer));
+		}
+		return std::uint64_t{paths.size()};
+	});
+
+	SDL::AssetLoader loader{renderer};
+	runner.run("assets/load/loader", [&]
+	{
+		std::vector<std::future<SDL::Surface>> pending;
+		for (auto const& path: paths)
+		{
+			pending.push_back(loader.loadSurface(path));
+		}
+		for (auto& f: pending)
+		{
+			while (f.wait_for(std::chrono::seconds{0}) != std::future_status::ready)
+			{
+				if (loader.drainUploads(std::chrono::milliseconds{2}) == 0)
+				{
+					std::this_thread::yield();
+				}
+			}
+			keep(f.get());
+		}
+		return std::uint64_t{paths.size()};
+	});
+
+	// the same images from an archive, as PNGs and pre-decoded
+	SDL::ArchiveWriter raw;
+	SDL::ArchiveWriter decoded;
+	for (auto const& path: paths)
+	{
+		raw.addFile(path.filename().string(), path);
+		decoded.addPixels(path.filename().string(), SDL::Surface{path});
+	}
+	raw.write(context.scratch / "raw.pak");
+	decoded.write(context.scratch / "decoded.pak");
+
+	for (auto name: {"raw", "decoded"})
+	{
+		SDL::Archive archive{context.scratch / (std::string{name} + ".pak")};
+		runner.run(std::string{"assets/load/archive_"} + name, [&]
+		{
+			for (auto const& path: paths)
+			{
+				SDL::Surface s{archive, path.filename().string()};
+				keep(s.getTexture(renderer));
+			}
+			return std::uint64_t{paths.size()};
+		});
+	}
+}
+}
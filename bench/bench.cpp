@@ -0,0 +1,153 @@
+#include "bench.h"
+
+#include <iomanip>
+
+#include "sdlpp/profiler.h"
+
+namespace Bench
+{
+namespace
+{
+void writeString(std::ostream& out, std::string const& s)
+{
+	out << '"';
+	for (auto c: s)
+	{
+		switch (c)
+		{
+			case '"': out << "\\\""; break;
+			case '\\': out << "\\\\"; break;
+			case '\n': out << "\\n"; break;
+			default: out << c;
+		}
+	}
+	out << '"';
+}
+
+double nsPerItem(Result const& r)
+{
+	return r.items == 0 ? 0 : static_cast<double>(r.elapsed.count()) / static_cast<double>(r.items);
+}
+}
+
+Runner::Runner(std::chrono::milliseconds minTime_, std::string filter_)
+	: minTime{minTime_}
+	, filter{std::move(filter_)}
+{}
+
+bool Runner::wants(std::string const& name) const
+{
+	return filter.empty() or name.find(filter) != std::string::npos;
+}
+
+Result* Runner::run(std::string const& name, std::function<std::uint64_t()> const& fn)
+{
+	if (not wants(name))
+	{
+		return nullptr;
+	}
+
+	using Clock = std::chrono::steady_clock;
+	fn();  // warm up caches, textures and allocations
+
+	SDL::Profiler::reset();
+	Result r;
+	r.name = name;
+	auto start = Clock::now();
+	do
+	{
+		r.items += fn();
+		++r.iterations;
+		r.elapsed = Clock::now() - start;
+	}
+	while (r.elapsed < minTime);
+	SDL::Profiler::endFrame(std::chrono::nanoseconds{0});
+
+	// only non-zero with the instrumented library
+	auto totals = SDL::Profiler::totals();
+	for (std::size_t i = 0; i < SDL::Profiler::counterCount; ++i)
+	{
+		if (totals.counters[i] != 0 and r.items != 0)
+		{
+			auto key = std::string{SDL::Profiler::getName(static_cast<SDL::Profiler::Counter>(i))} + " per item";
+			r.metrics[key] = static_cast<double>(totals.counters[i]) / static_cast<double>(r.items);
+		}
+	}
+
+	results.push_back(std::move(r));
+	return &results.back();
+}
+
+void Runner::skip(std::string const& name, std::string reason)
+{
+	if (wants(name))
+	{
+		Result r;
+		r.name = name;
+		r.skipped = std::move(reason);
+		results.push_back(std::move(r));
+	}
+}
+
+void Runner::writeJson(std::ostream& out, std::map<std::string, std::string> const& environment) const
+{
+	out << std::setprecision(6) << "{\n  \"suite\": \"sdlpp_bench\",\n  \"environment\": {";
+	auto first = true;
+	for (auto const& [key, value]: environment)
+	{
+		out << (first ? "\n    " : ",\n    ");
+		writeString(out, key);
+		out << ": ";
+		writeString(out, value);
+		first = false;
+	}
+	out << "\n  },\n  \"results\": [";
+
+	first = true;
+	for (auto const& r: results)
+	{
+		out << (first ? "\n    {" : ",\n    {");
+		first = false;
+		out << "\"name\": ";
+		writeString(out, r.name);
+		if (r.skipped)
+		{
+			out << ", \"skipped\": ";
+			writeString(out, *r.skipped);
+			out << '}';
+			continue;
+		}
+		out << ", \"iterations\": " << r.iterations
+			<< ", \"items\": " << r.items
+			<< ", \"elapsed_ns\": " << r.elapsed.count()
+			<< ", \"ns_per_item\": " << nsPerItem(r);
+		for (auto const& [key, value]: r.metrics)
+		{
+			out << ", ";
+			writeString(out, key);
+			out << ": " << value;
+		}
+		out << '}';
+	}
+	out << "\n  ]\n}\n";
+}
+
+void Runner::writeTable(std::ostream& out) const
+{
+	for (auto const& r: results)
+	{
+		out << std::left << std::setw(48) << r.name;
+		if (r.skipped)
+		{
+			out << "skipped: " << *r.skipped << '\n';
+			continue;
+		}
+		out << std::right << std::setw(14) << std::fixed << std::setprecision(1) << nsPerItem(r) << " ns/item";
+		for (auto const& [key, value]: r.metrics)
+		{
+			out << "  " << key << '=' << std::setprecision(3) << value;
+		}
+		out << '\n';
+	}
+}
+}
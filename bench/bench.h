@@ -0,0 +1,79 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace SDL
+{
+class Renderer;
+
+class Window;
+}
+
+namespace Bench
+{
+struct Result
+{
+	std::string name;
+	std::uint64_t iterations = 0;  // calls of the measured function
+	std::uint64_t items = 0;  // units of work, ns per item is what gets compared
+	std::chrono::nanoseconds elapsed{0};
+	std::map<std::string, double> metrics;  // draw calls per item, hit rates, ...
+	std::optional<std::string> skipped;
+};
+
+struct Context
+{
+	SDL::Window& window;
+	SDL::Renderer& renderer;
+	std::optional<std::filesystem::path> font;
+	std::filesystem::path scratch;  // per-run directory for generated assets
+};
+
+/* Runs each benchmark function until it has taken at least the minimum time
+ * and records the result. A function returns how many items it processed,
+ * so cheap operations can be measured in batches. */
+class Runner
+{
+	public:
+		Runner(std::chrono::milliseconds minTime, std::string filter);
+
+		bool wants(std::string const& name) const;
+
+		// returns the result, so callers can attach metrics
+		Result* run(std::string const& name, std::function<std::uint64_t()> const& fn);
+		void skip(std::string const& name, std::string reason);
+
+		void writeJson(std::ostream& out, std::map<std::string, std::string> const& environment) const;
+		void writeTable(std::ostream& out) const;
+
+	private:
+		std::chrono::milliseconds minTime;
+		std::string filter;
+		std::vector<Result> results;
+};
+
+// defined in the other bench/*.cpp files, one per area
+void renderBenchmarks(Runner& runner, Context& context);
+void textBenchmarks(Runner& runner, Context& context);
+void eventBenchmarks(Runner& runner, Context& context);
+void surfaceBenchmarks(Runner& runner, Context& context);
+void assetBenchmarks(Runner& runner, Context& context);
+void spatialBenchmarks(Runner& runner, Context& context);
+void geometryBenchmarks(Runner& runner, Context& context);
+void layoutBenchmarks(Runner& runner, Context& context);
+
+// keeps the optimizer from discarding a result
+template<typename T>
+void keep(T const& value)
+{
+	asm volatile("" : : "g"(&value) : "memory");
+}
+}
@@ -0,0 +1,259 @@
+#include "bench.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "sdlpp/dispatcher.h"
+#include "sdlpp/events.h"
+
+namespace Bench
+{
+namespace
+{
+constexpr int batch = 1000;
+
+/* The EventQueue as it was before the ring buffer (a mutex, a condition
+ * variable and a std::queue), kept as the baseline to compare against. */
+class MutexQueue
+{
+	public:
+		void push(SDL::Event ev)
+		{
+			std::unique_lock<std::mutex> pin{m};
+			queue_.push(std::move(ev));
+			cv.notify_all();
+		}
+
+		std::optional<SDL::Event> try_pop()
+		{
+			std::unique_lock<std::mutex> pin{m};
+			if (queue_.empty())
+			{
+				return std::nullopt;
+			}
+			auto ev = std::move(queue_.front());
+			queue_.pop();
+			return ev;
+		}
+
+		SDL::Event wait_pop()
+		{
+			std::unique_lock<std::mutex> pin{m};
+			cv.wait(pin, [this] { return not queue_.empty(); });
+			auto ev = std::move(queue_.front());
+			queue_.pop();
+			return ev;
+		}
+
+	private:
+		std::mutex m;
+		std::condition_variable cv;
+		std::queue<SDL::Event> queue_;
+};
+
+SDL_Event motion(std::uint32_t source, std::int32_t sequence)
+{
+	SDL_Event raw{};
+	raw.motion.type = SDL_MOUSEMOTION;
+	raw.motion.windowID = source;
+	raw.motion.which = source;
+	raw.motion.x = sequence;
+	raw.motion.y = 0;
+	raw.motion.xrel = 1;
+	return raw;
+}
+
+/* producers x consumers threads pass perProducer events each. Delivery is
+ * checked by tests/eventqueue.cpp, this only measures. */
+template<typename Queue>
+void stress(Queue& queue, int producers, int consumers, int perProducer)
+{
+	std::atomic<int> remaining{producers * perProducer};
+
+	std::vector<std::jthread> threads;
+	for (int c = 0; c < consumers; ++c)
+	{
+		threads.emplace_back([&]
+		{
+			while (remaining.load(std::memory_order_relaxed) > 0)
+			{
+				auto ev = queue.try_pop();
+				if (not ev)
+				{
+					std::this_thread::yield();
+					continue;
+				}
+				keep(*ev);
+				remaining.fetch_sub(1, std::memory_order_relaxed);
+			}
+		});
+	}
+	for (int p = 0; p < producers; ++p)
+	{
+		threads.emplace_back([&queue, p, perProducer]
+		{
+			for (int i = 0; i < perProducer; ++i)
+			{
+				queue.push(SDL::Event::fromSdlEvent(motion(static_cast<std::uint32_t>(p), i)));
+			}
+		});
+	}
+}
+
+/* Producer to consumer handoff latency: an event bounces between this thread
+ * and an echo thread, both blocked in wait_pop while it is on its way, so each
+ * item is one handoff. */
+template<typename Queue>
+void handoff(Runner& runner, std::string const& name)
+{
+	constexpr int roundTrips = 1000;
+	Queue there;
+	Queue back;
+	std::jthread echo{[&]
+	{
+		while (true)
+		{
+			auto ev = there.wait_pop();
+			if (ev.type == SDL::EventType::Quit)
+			{
+				return;
+			}
+			back.push(std::move(ev));
+		}
+	}};
+
+	auto ping = SDL::Event::fromSdlEvent(motion(0, 0));
+	runner.run(name, [&]
+	{
+		for (int i = 0; i < roundTrips; ++i)
+		{
+			there.push(ping);
+			keep(back.wait_pop());
+		}
+		return std::uint64_t{2 * roundTrips};
+	});
+	there.push(SDL::Event{SDL::EventType::Quit, 0});
+}
+}
+
+void eventBenchmarks(Runner& runner, Context&)
+{
+	std::vector<SDL::Event> events;
+	for (int i = 0; i < batch; ++i)
+	{
+		events.push_back(SDL::Event::fromSdlEvent(motion(0, i)));
+	}
+
+	runner.run("event/from_sdl_event", [&]
+	{
+		for (int i = 0; i < batch; ++i)
+		{
+			keep(SDL::Event::fromSdlEvent(motion(0, i)));
+		}
+		return std::uint64_t{batch};
+	});
+
+	SDL::EventQueue queue;
+	runner.run("event_queue/push_pop", [&]
+	{
+		for (auto const& ev: events)
+		{
+			queue.push(ev);
+		}
+		while (auto ev = queue.try_pop())
+		{
+			keep(*ev);
+		}
+		return std::uint64_t{batch};
+	});
+
+	std::vector<SDL::Event> chunk;
+	std::vector<SDL::Event> out;
+	runner.run("event_queue/push_many_pop_many", [&]
+	{
+		chunk = events;
+		queue.push_many(chunk);
+		out.clear();
+		queue.pop_many(out, batch);
+		return std::uint64_t{batch};
+	});
+
+	MutexQueue baseline;
+	runner.run("mutex_queue/push_pop", [&]
+	{
+		for (auto const& ev: events)
+		{
+			baseline.push(ev);
+		}
+		while (auto ev = baseline.try_pop())
+		{
+			keep(*ev);
+		}
+		return std::uint64_t{batch};
+	});
+
+	// contended throughput
+	constexpr int perProducer = 20000;
+	for (auto [producers, consumers]: {std::pair{1, 1}, std::pair{4, 4}})
+	{
+		auto suffix = "/" + std::to_string(producers) + "x" + std::to_string(consumers);
+		runner.run("event_queue/stress" + suffix, [&, producers = producers, consumers = consumers]
+		{
+			stress(queue, producers, consumers, perProducer);
+			return static_cast<std::uint64_t>(producers * perProducer);
+		});
+		runner.run("mutex_queue/stress" + suffix, [&, producers = producers, consumers = consumers]
+		{
+			stress(baseline, producers, consumers, perProducer);
+			return static_cast<std::uint64_t>(producers * perProducer);
+		});
+	}
+
+	// latency of waking a blocked consumer
+	handoff<SDL::EventQueue>(runner, "event_queue/handoff");
+	handoff<MutexQueue>(runner, "mutex_queue/handoff");
+
+	// pumping a burst of mouse motion from SDL, with and without coalescing
+	for (auto coalescing: {false, true})
+	{
+		queue.setCoalescing(coalescing);
+		std::uint64_t coalesced = 0;
+		auto r = runner.run(std::string{"event_queue/pump"} + (coalescing ? "/coalescing" : "/plain"), [&]
+		{
+			for (int i = 0; i < batch; ++i)
+			{
+				auto raw = motion(1, i);
+				SDL_PushEvent(&raw);
+			}
+			coalesced += queue.pumpEvents().coalesced;
+			out.clear();
+			while (queue.pop_many(out, batch) != 0)
+			{
+				out.clear();
+			}
+			return std::uint64_t{batch};
+		});
+		if (r)
+		{
+			r->metrics["coalesced per item"] = static_cast<double>(coalesced) / static_cast<double>(r->items);
+		}
+	}
+	queue.setCoalescing(false);
+
+	SDL::EventDispatcher dispatcher;
+	std::uint64_t handled = 0;
+	dispatcher.subscribe(SDL::EventType::MouseMotion, [&handled](SDL::Event const&) { ++handled; });
+	runner.run("dispatcher/dispatch_span", [&]
+	{
+		dispatcher.dispatch(std::span<SDL::Event const>{events});
+		return std::uint64_t{batch};
+	});
+	keep(handled);
+}
+}
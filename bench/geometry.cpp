@@ -0,0 +1,180 @@
+#include "bench.h"
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "sdlpp/geometryops.h"
+#include "sdlpp/pixelops.h"
+
+namespace Bench
+{
+namespace
+{
+constexpr std::size_t count = 10'000;  // a large layout pass
+
+char const* isaName(SDL::PixelOps::Isa isa)
+{
+	switch (isa)
+	{
+		case SDL::PixelOps::Isa::Scalar: return "scalar";
+		case SDL::PixelOps::Isa::SSE2: return "sse2";
+		case SDL::PixelOps::Isa::AVX2: return "avx2";
+	}
+	return "unknown";
+}
+
+template<typename T>
+bool sameElements(std::vector<T> const& expected, auto const& actual)
+{
+	for (std::size_t i = 0; i < expected.size(); ++i)
+	{
+		if (not (expected[i] == actual[i]))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+}
+
+void geometryBenchmarks(Runner& runner, Context&)
+{
+	namespace Ops = SDL::GeometryOps;
+
+	// includes empty and negative sizes, which the operations must treat
+	// exactly as the scalar functions do
+	std::mt19937 rng{11};
+	std::uniform_int_distribution<int> pos{-2000, 2000};
+	std::uniform_int_distribution<int> size{-8, 400};
+	std::vector<SDL::Rect> rects;
+	std::vector<SDL::Point> points;
+	Ops::RectArray rectArray;
+	Ops::PointArray pointArray;
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		SDL::Rect r{{pos(rng), pos(rng)}, {size(rng), size(rng)}};
+		SDL::Point p{pos(rng), pos(rng)};
+		rects.push_back(r);
+		points.push_back(p);
+		rectArray.push_back(r);
+		pointArray.push_back(p);
+	}
+	SDL::Rect const area{{-500, -300}, {1000, 600}};
+	SDL::Point const cursor{12, -7};
+	auto const align = SDL::Alignment::MiddleCenter;
+
+	// scalar references, one element at a time over an array of Rects
+	std::vector<SDL::Rect> aligned;
+	std::vector<std::uint8_t> inside;
+	std::vector<std::uint8_t> containing;
+	std::vector<std::uint8_t> intersecting;
+	std::vector<SDL::Rect> clipped;
+	SDL::Rect bounds{{0, 0}, {0, 0}};
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		aligned.push_back({rects[i].p, rects[i].s, align});
+		inside.push_back(points[i].in(area));
+		containing.push_back(cursor.in(rects[i]));
+		intersecting.push_back(rects[i].intersects(area));
+		clipped.push_back(rects[i].clipped(area));
+		bounds = bounds.united(rects[i]);
+	}
+
+	std::vector<SDL::Rect> rectOut(count, SDL::Rect{{0, 0}, {0, 0}});
+	std::vector<std::uint8_t> maskOut(count);
+	runner.run("geometry/align_rects/per_rect", [&]
+	{
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			rectOut[i] = {rects[i].p, rects[i].s, align};
+		}
+		keep(rectOut);
+		return std::uint64_t{count};
+	});
+	runner.run("geometry/intersect_rects/per_rect", [&]
+	{
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			maskOut[i] = rects[i].intersects(area);
+		}
+		keep(maskOut);
+		return std::uint64_t{count};
+	});
+	runner.run("geometry/clip_rects/per_rect", [&]
+	{
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			rectOut[i] = rects[i].clipped(area);
+		}
+		keep(rectOut);
+		return std::uint64_t{count};
+	});
+
+	auto supported = SDL::PixelOps::supportedIsa();
+	Ops::RectArray out;
+	out.resize(count);
+	for (auto isa: {SDL::PixelOps::Isa::Scalar, SDL::PixelOps::Isa::SSE2, SDL::PixelOps::Isa::AVX2})
+	{
+		if (isa > supported)
+		{
+			runner.skip(std::string{"geometry/"} + isaName(isa), "not supported by this CPU");
+			continue;
+		}
+		SDL::PixelOps::setIsa(isa);
+		auto suffix = std::string{"/"} + isaName(isa);
+
+		if (auto r = runner.run("geometry/align_rects" + suffix, [&]
+		{
+			Ops::alignRects(rectArray, align, out);
+			return std::uint64_t{count};
+		}))
+		{
+			r->metrics["matches scalar"] = sameElements(aligned, out);
+		}
+		if (auto r = runner.run("geometry/contains_points" + suffix, [&]
+		{
+			keep(Ops::containsPoints(area, pointArray, maskOut));
+			return std::uint64_t{count};
+		}))
+		{
+			r->metrics["matches scalar"] = sameElements(inside, maskOut);
+		}
+		if (auto r = runner.run("geometry/rects_containing" + suffix, [&]
+		{
+			keep(Ops::rectsContaining(rectArray, cursor, maskOut));
+			return std::uint64_t{count};
+		}))
+		{
+			r->metrics["matches scalar"] = sameElements(containing, maskOut);
+		}
+		if (auto r = runner.run("geometry/intersect_rects" + suffix, [&]
+		{
+			keep(Ops::intersectRects(rectArray, area, maskOut));
+			return std::uint64_t{count};
+		}))
+		{
+			r->metrics["matches scalar"] = sameElements(intersecting, maskOut);
+		}
+		SDL::Rect united{{0, 0}, {0, 0}};
+		if (auto r = runner.run("geometry/union_bounds" + suffix, [&]
+		{
+			united = Ops::unionBounds(rectArray);
+			keep(united);
+			return std::uint64_t{count};
+		}))
+		{
+			r->metrics["matches scalar"] = united == bounds;
+		}
+		if (auto r = runner.run("geometry/clip_rects" + suffix, [&]
+		{
+			Ops::clipRects(rectArray, area, out);
+			return std::uint64_t{count};
+		}))
+		{
+			r->metrics["matches scalar"] = sameElements(clipped, out);
+		}
+	}
+	SDL::PixelOps::setIsa(supported);
+}
+}
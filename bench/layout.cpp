@@ -0,0 +1,164 @@
+#include "bench.h"
+
+#include <random>
+#include <vector>
+
+#include "sdlpp/layout.h"
+
+namespace Bench
+{
+namespace
+{
+constexpr SDL::Size viewport{1920, 1080};
+constexpr int rows = 40;
+constexpr int columns = 40;
+
+// a form-like UI: a column of rows of labels, next to a grid of icons
+struct Ui
+{
+	SDL::Layout layout;
+	std::vector<SDL::Layout::Id> labels;
+	std::vector<SDL::Layout::Id> icons;
+};
+
+Ui buildUi()
+{
+	using Direction = SDL::Layout::Direction;
+	std::mt19937 rng{3};
+	std::uniform_int_distribution<int> width{20, 40};
+
+	Ui ui;
+	auto& l = ui.layout;
+	auto root = l.addStack(std::nullopt, Direction::Horizontal, 8);
+	l.setPadding(root, 8);
+	l.setStretch(root, true);
+
+	auto form = l.addStack(root, Direction::Vertical, 2);
+	l.setStretch(form, true);
+	for (int r = 0; r < rows; ++r)
+	{
+		auto row = l.addStack(form, Direction::Horizontal, 4);
+		for (int c = 0; c < 10; ++c)
+		{
+			auto label = l.addBox(row);
+			l.setContentSize(label, {width(rng), 20});
+			l.setAlignment(label, SDL::Alignment::MiddleLeft);
+			ui.labels.push_back(label);
+		}
+	}
+
+	auto grid = l.addGrid(root, columns, 2);
+	for (int i = 0; i < columns * rows; ++i)
+	{
+		auto icon = l.addBox(grid);
+		l.setContentSize(icon, {16, 16});
+		l.setAlignment(icon, SDL::Alignment::MiddleCenter);
+		ui.icons.push_back(icon);
+	}
+	return ui;
+}
+
+bool sameRects(SDL::Layout const& a, SDL::Layout const& b, std::vector<SDL::Layout::Id> const& ids)
+{
+	for (auto id: ids)
+	{
+		if (not (a.getRect(id) == b.getRect(id)))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+}
+
+void layoutBenchmarks(Runner& runner, Context&)
+{
+	auto ui = buildUi();
+	auto& layout = ui.layout;
+	layout.update(viewport);
+	auto nodes = layout.size();
+
+	std::size_t relaid = 0;
+	std::uint64_t passes = 0;
+	auto report = [&](Result* r)
+	{
+		if (r)
+		{
+			r->metrics["nodes"] = static_cast<double>(nodes);
+			r->metrics["relaid per pass"] = static_cast<double>(relaid) / static_cast<double>(passes);
+		}
+		relaid = 0;
+		passes = 0;
+	};
+
+	// what re-running layout from scratch each frame costs
+	report(runner.run("layout/full", [&]
+	{
+		layout.invalidate();
+		layout.update(viewport);
+		relaid += layout.getStats().relaid;
+		++passes;
+		return std::uint64_t{1};
+	}));
+
+	report(runner.run("layout/unchanged", [&]
+	{
+		layout.update(viewport);
+		relaid += layout.getStats().relaid;
+		++passes;
+		return std::uint64_t{1};
+	}));
+
+	// a label's text changed, shifting the rest of its row
+	int frame = 0;
+	report(runner.run("layout/one_label", [&]
+	{
+		// every label in turn, alternating between two widths on each round
+		auto round = static_cast<std::size_t>(frame) / ui.labels.size();
+		auto label = ui.labels[static_cast<std::size_t>(frame) % ui.labels.size()];
+		layout.setContentSize(label, {round % 2 == 0 ? 44 : 24, 20});
+		++frame;
+		layout.update(viewport);
+		relaid += layout.getStats().relaid;
+		++passes;
+		return std::uint64_t{1};
+	}));
+
+	// an icon changed size, resizing its column and row
+	frame = 0;
+	report(runner.run("layout/one_icon", [&]
+	{
+		auto round = static_cast<std::size_t>(frame) / ui.icons.size();
+		auto icon = ui.icons[static_cast<std::size_t>(frame) % ui.icons.size()];
+		layout.setContentSize(icon, round % 2 == 0 ? SDL::Size{24, 24} : SDL::Size{16, 16});
+		++frame;
+		layout.update(viewport);
+		relaid += layout.getStats().relaid;
+		++passes;
+		return std::uint64_t{1};
+	}));
+
+	frame = 0;
+	auto resized = viewport;
+	auto resize = runner.run("layout/resize", [&]
+	{
+		resized.w = viewport.w - frame % 64;
+		++frame;
+		layout.update(resized);
+		relaid += layout.getStats().relaid;
+		++passes;
+		return std::uint64_t{1};
+	});
+	// the incremental passes must have reached the same result as a full one
+	if (resize)
+	{
+		auto full = layout;
+		full.invalidate();
+		full.update(resized);
+		auto ids = ui.labels;
+		ids.insert(ids.end(), ui.icons.begin(), ui.icons.end());
+		resize->metrics["matches full layout"] = sameRects(layout, full, ids);
+	}
+	report(resize);
+}
+}
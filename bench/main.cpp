@@ -0,0 +1,146 @@
+// sdlpp_bench: headless benchmarks on SDL's dummy video driver and software
+// renderer. Results are written as JSON, to stdout unless --out is given.
+//
+//   sdlpp_bench [--out results.json] [--filter substring] [--min-time ms] [--font file.ttf]
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "bench.h"
+
+#include "sdlpp/pixelops.h"
+#include "sdlpp/sdl.h"
+#include "sdlpp/video.h"
+
+namespace
+{
+// fonts are not shipped with sdlpp, use a common system one unless told otherwise
+std::optional<std::filesystem::path> findFont(char const* given)
+{
+	if (given != nullptr)
+	{
+		return std::filesystem::path{given};
+	}
+	if (auto env = std::getenv("SDLPP_BENCH_FONT"))
+	{
+		return std::filesystem::path{env};
+	}
+	for (auto candidate: {
+		"/usr/share/fonts/truetype/dejavu/DejaVuSans.ttf",
+		"/usr/share/fonts/TTF/DejaVuSans.ttf",
+		"/usr/share/fonts/dejavu/DejaVuSans.ttf",
+		"/Library/Fonts/Arial.ttf",
+		"C:/Windows/Fonts/arial.ttf",
+	})
+	{
+		if (std::filesystem::exists(candidate))
+		{
+			return std::filesystem::path{candidate};
+		}
+	}
+	return std::nullopt;
+}
+}
+
+int main(int argc, char* argv[])
+{
+	char const* out = nullptr;
+	char const* font = nullptr;
+	std::string filter;
+	long minTime = 200;
+	for (int i = 1; i < argc; ++i)
+	{
+		auto arg = [&](char const* name)
+		{
+			return std::strcmp(argv[i], name) == 0 and i + 1 < argc;
+		};
+		if (arg("--out"))
+		{
+			out = argv[++i];
+		}
+		else if (arg("--filter"))
+		{
+			filter = argv[++i];
+		}
+		else if (arg("--min-time"))
+		{
+			minTime = std::strtol(argv[++i], nullptr, 10);
+		}
+		else if (arg("--font"))
+		{
+			font = argv[++i];
+		}
+		else
+		{
+			std::cerr << "usage: " << argv[0] << " [--out file] [--filter substring] [--min-time ms] [--font file]\n";
+			return 2;
+		}
+	}
+
+	// headless unless the caller asked for something else
+	SDL_setenv("SDL_VIDEODRIVER", "dummy", 0);
+	SDL_setenv("SDL_AUDIODRIVER", "dummy", 0);
+	SDL_SetHint(SDL_HINT_RENDER_DRIVER, "software");
+
+	try
+	{
+		SDL::Init init;
+		SDL::Window window{"sdlpp_bench", {1280, 720}};
+
+		auto scratch = std::filesystem::temp_directory_path() / ("sdlpp_bench." + std::to_string(std::chrono::system_clock::now().time_since_epoch().count()));
+		std::filesystem::create_directories(scratch);
+
+		Bench::Context context{window, window.getRenderer(), findFont(font), scratch};
+		Bench::Runner runner{std::chrono::milliseconds{minTime}, filter};
+
+		Bench::renderBenchmarks(runner, context);
+		Bench::textBenchmarks(runner, context);
+		Bench::eventBenchmarks(runner, context);
+		Bench::surfaceBenchmarks(runner, context);
+		Bench::assetBenchmarks(runner, context);
+		Bench::spatialBenchmarks(runner, context);
+		Bench::geometryBenchmarks(runner, context);
+		Bench::layoutBenchmarks(runner, context);
+
+		std::filesystem::remove_all(scratch);
+
+		SDL_RendererInfo info;
+		SDL_GetRendererInfo(context.renderer.get(), &info);
+		std::map<std::string, std::string> environment{
+			{"video_driver", SDL_GetCurrentVideoDriver()},
+			{"render_driver", info.name},
+			{"pixelops_isa", std::to_string(static_cast<int>(SDL::PixelOps::activeIsa()))},
+#ifdef SDLPP_PROFILING
+			{"profiling", "on"},
+#else
+			{"profiling", "off"},
+#endif
+		};
+
+		runner.writeTable(std::cerr);
+		if (out != nullptr)
+		{
+			std::ofstream file{out};
+			runner.writeJson(file, environment);
+			if (not file)
+			{
+				std::cerr << argv[0] << ": failed to write " << out << '\n';
+				return 1;
+			}
+		}
+		else
+		{
+			runner.writeJson(std::cout, environment);
+		}
+	}
+	catch (std::exception const& e)
+	{
+		std::cerr << argv[0] << ": " << e.what() << '\n';
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,288 @@
+#include "bench.h"
+
+#include <array>
+#include <random>
+#include <vector>
+
+#include "sdlpp/atlas.h"
+#include "sdlpp/rendertarget.h"
+#include "sdlpp/spritebatch.h"
+#include "sdlpp/surface.h"
+#include "sdlpp/tilemap.h"
+#include "sdlpp/video.h"
+
+namespace Bench
+{
+namespace
+{
+constexpr int primitives = 1000;
+constexpr int sprites = 1000;
+
+std::array<SDL::Color, 4> const palette{
+	SDL::Color{0xE0, 0x40, 0x40}, SDL::Color{0x40, 0xE0, 0x40},
+	SDL::Color{0x40, 0x40, 0xE0}, SDL::Color{0xE0, 0xE0, 0x40, 0x80},
+};
+
+struct Scene
+{
+	std::vector<SDL::Rect> rects;
+	std::vector<SDL::Color> colors;
+};
+
+Scene makeScene(SDL::Size area, int count, int maxSide)
+{
+	std::mt19937 rng{42};
+	std::uniform_int_distribution<int> x{0, area.w - maxSide};
+	std::uniform_int_distribution<int> y{0, area.h - maxSide};
+	std::uniform_int_distribution<int> side{1, maxSide};
+	std::uniform_int_distribution<std::size_t> color{0, palette.size() - 1};
+
+	Scene scene;
+	for (int i = 0; i < count; ++i)
+	{
+		scene.rects.push_back({{x(rng), y(rng)}, {side(rng), side(rng)}});
+		scene.colors.push_back(palette[color(rng)]);
+	}
+	return scene;
+}
+
+// the same primitives immediately and through the draw-command batch
+template<typename Draw>
+void primitivePair(Runner& runner, SDL::Renderer& renderer, std::string const& name, Draw draw)
+{
+	for (auto batched: {false, true})
+	{
+		renderer.setBatching(batched);
+		runner.run("renderer/" + name + (batched ? "/batched" : "/immediate"), [&]
+		{
+			draw();
+			renderer.flush();
+			return std::uint64_t{primitives};
+		});
+	}
+	renderer.setBatching(false);
+}
+}
+
+void renderBenchmarks(Runner& runner, Context& context)
+{
+	auto& renderer = context.renderer;
+	auto area = renderer.getViewport().s;
+	auto scene = makeScene(area, primitives, 64);
+
+	primitivePair(runner, renderer, "fill_rect", [&]
+	{
+		for (std::size_t i = 0; i < scene.rects.size(); ++i)
+		{
+			renderer.fillRect(scene.rects[i], scene.colors[i]);
+		}
+	});
+	primitivePair(runner, renderer, "draw_rect", [&]
+	{
+		for (std::size_t i = 0; i < scene.rects.size(); ++i)
+		{
+			renderer.drawRect(scene.rects[i], scene.colors[i]);
+		}
+	});
+	primitivePair(runner, renderer, "draw_line", [&]
+	{
+		for (std::size_t i = 0; i < scene.rects.size(); ++i)
+		{
+			auto const& r = scene.rects[i];
+			renderer.drawLine(r.p, {r.p.x + r.s.w, r.p.y + r.s.h}, scene.colors[i]);
+		}
+	});
+	primitivePair(runner, renderer, "put_pixel", [&]
+	{
+		for (std::size_t i = 0; i < scene.rects.size(); ++i)
+		{
+			renderer.putPixel(scene.rects[i].p, scene.colors[i]);
+		}
+	});
+
+	// sprites: eight 32x32 surfaces drawn as separate textures and from an atlas
+	std::vector<SDL::Surface> surfaces;
+	for (int i = 0; i < 8; ++i)
+	{
+		auto& s = surfaces.emplace_back(SDL::Size{32, 32});
+		s.fillRect({{0, 0}, {32, 32}}, palette[static_cast<std::size_t>(i) % palette.size()]);
+	}
+	SDL::Atlas atlas{renderer, {256, 256}};
+	std::vector<SDL::AtlasHandle> handles;
+	for (auto const& s: surfaces)
+	{
+		handles.push_back(atlas.insert(s));
+	}
+	auto positions = makeScene(area, sprites, 32);
+
+	for (auto batched: {false, true})
+	{
+		renderer.setBatching(batched);
+		runner.run(std::string{"renderer/copy_surface"} + (batched ? "/batched" : "/immediate"), [&]
+		{
+			for (std::size_t i = 0; i < positions.rects.size(); ++i)
+			{
+				renderer.copySurface(surfaces[i % surfaces.size()], positions.rects[i].p);
+			}
+			renderer.flush();
+			return std::uint64_t{sprites};
+		});
+		runner.run(std::string{"renderer/copy_atlas"} + (batched ? "/batched" : "/immediate"), [&]
+		{
+			for (std::size_t i = 0; i < positions.rects.size(); ++i)
+			{
+				renderer.copySurface(handles[i % handles.size()], positions.rects[i].p);
+			}
+			renderer.flush();
+			return std::uint64_t{sprites};
+		});
+	}
+	renderer.setBatching(false);
+
+	// particles: many small quads from one atlas, the same positions through each path
+	constexpr int particles = 20000;
+	auto particleScene = makeScene(area, particles, 16);
+	renderer.setBatching(true);
+	runner.run("particles/copy_atlas/batched", [&]
+	{
+		for (std::size_t i = 0; i < particleScene.rects.size(); ++i)
+		{
+			renderer.copySurface(handles[0], particleScene.rects[i].p);
+		}
+		renderer.flush();
+		return std::uint64_t{particles};
+	});
+	renderer.setBatching(false);
+
+	SDL::SpriteBatch spriteBatch{renderer};
+	for (auto rotated: {false, true})
+	{
+		float spin = 0;
+		runner.run(std::string{"particles/sprite_batch"} + (rotated ? "/rotated_tinted" : "/plain"), [&]
+		{
+			for (std::size_t i = 0; i < particleScene.rects.size(); ++i)
+			{
+				SDL::Sprite sprite;
+				sprite.position = {static_cast<float>(particleScene.rects[i].p.x), static_cast<float>(particleScene.rects[i].p.y)};
+				if (rotated)
+				{
+					sprite.rotation = spin + static_cast<float>(i);
+					sprite.scale = {0.5f, 0.5f};
+					sprite.tint = particleScene.colors[i];
+				}
+				spriteBatch.draw(handles[0], sprite);
+			}
+			spriteBatch.flush();
+			spin += 1;
+			return std::uint64_t{particles};
+		});
+	}
+
+	// a 512x512 map of 16px tiles from a 16x16 tileset, scrolling one pixel per frame
+	constexpr SDL::Size tile{16, 16};
+	SDL::Surface tileset{{tile.w * 16, tile.h * 16}};
+	for (int i = 0; i < 256; ++i)
+	{
+		tileset.fillRect({{(i % 16) * tile.w, (i / 16) * tile.h}, tile}, palette[static_cast<std::size_t>(i) % palette.size()]);
+	}
+	SDL::TileMap map{renderer, tileset, tile, {512, 512}};
+	for (int y = 0; y < 512; ++y)
+	{
+		for (int x = 0; x < 512; ++x)
+		{
+			map.set({x, y}, static_cast<SDL::TileMap::Tile>((x * 31 + y * 17) % 256));
+		}
+	}
+
+	int scroll = 0;
+	runner.run("tilemap/per_tile_copy", [&]
+	{
+		SDL::Point camera{scroll % 4096, scroll % 4096};
+		++scroll;
+		auto x0 = camera.x / tile.w;
+		auto y0 = camera.y / tile.h;
+		for (int y = y0; y <= y0 + area.h / tile.h; ++y)
+		{
+			for (int x = x0; x <= x0 + area.w / tile.w; ++x)
+			{
+				auto t = map.get({x, y});
+				SDL::Rect src{{(t % 16) * tile.w, (t / 16) * tile.h}, tile};
+				renderer.copySurface(tileset, src, {x * tile.w - camera.x, y * tile.h - camera.y});
+			}
+		}
+		return std::uint64_t{1};
+	});
+	scroll = 0;
+	if (auto r = runner.run("tilemap/chunked", [&]
+	{
+		map.draw({scroll % 4096, scroll % 4096});
+		++scroll;
+		return std::uint64_t{1};
+	}))
+	{
+		r->metrics["visible chunks"] = static_cast<double>(map.getStats().visibleChunks);
+	}
+	runner.run("tilemap/chunked/editing", [&]
+	{
+		map.set({scroll % 64, scroll % 32}, static_cast<SDL::TileMap::Tile>(scroll % 256));
+		map.draw({0, 0});
+		++scroll;
+		return std::uint64_t{1};
+	});
+
+	if (auto r = runner.run("atlas/insert_erase", [&]
+	{
+		for (auto const& s: surfaces)
+		{
+			atlas.erase(atlas.insert(s));
+		}
+		return std::uint64_t{surfaces.size()};
+	}))
+	{
+		r->metrics["pages"] = static_cast<double>(atlas.pageCount());
+	}
+
+	// a static UI panel: redrawn from primitives every frame vs drawn once into a target
+	SDL::Size const panelSize{400, 300};
+	auto panel = makeScene(panelSize, 500, 24);
+	auto drawPanel = [&]
+	{
+		for (std::size_t i = 0; i < panel.rects.size(); ++i)
+		{
+			renderer.fillRect(panel.rects[i], panel.colors[i]);
+		}
+	};
+	for (auto batched: {false, true})
+	{
+		renderer.setBatching(batched);
+		runner.run(std::string{"renderer/static_panel/redraw"} + (batched ? "/batched" : "/immediate"), [&]
+		{
+			renderer.clear(SDL::Color{});
+			drawPanel();
+			renderer.present();
+			return std::uint64_t{1};
+		});
+	}
+	renderer.setBatching(false);
+
+	SDL::RenderTarget target{renderer, panelSize};
+	{
+		auto scope = renderer.setTarget(target);
+		drawPanel();
+	}
+	runner.run("renderer/static_panel/render_target", [&]
+	{
+		renderer.clear(SDL::Color{});
+		renderer.copySurface(target, {0, 0});
+		renderer.present();
+		return std::uint64_t{1};
+	});
+
+	runner.run("renderer/clear_present", [&]
+	{
+		renderer.clear(SDL::Color{});
+		renderer.present();
+		return std::uint64_t{1};
+	});
+}
+}
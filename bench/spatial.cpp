@@ -0,0 +1,165 @@
+#include "bench.h"
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "sdlpp/spatial.h"
+
+namespace Bench
+{
+namespace
+{
+constexpr SDL::Rect world{{0, 0}, {32768, 32768}};
+constexpr int queries = 256;
+
+// the baseline: every rect tested for every query, over flat arrays
+struct LinearScan
+{
+	std::vector<SDL::Rect> rects;
+
+	std::size_t query(SDL::Point p, std::vector<std::uint32_t>& out) const
+	{
+		std::size_t found = 0;
+		for (std::uint32_t i = 0; i < rects.size(); ++i)
+		{
+			if (p.in(rects[i]))
+			{
+				out.push_back(i);
+				++found;
+			}
+		}
+		return found;
+	}
+
+	std::size_t query(SDL::Rect r, std::vector<std::uint32_t>& out) const
+	{
+		std::size_t found = 0;
+		for (std::uint32_t i = 0; i < rects.size(); ++i)
+		{
+			if (rects[i].intersects(r))
+			{
+				out.push_back(i);
+				++found;
+			}
+		}
+		return found;
+	}
+};
+
+// mostly widget-sized rects with the odd large one
+std::vector<SDL::Rect> makeRects(std::size_t count, std::mt19937& rng)
+{
+	std::uniform_int_distribution<int> pos{0, world.s.w - 1};
+	std::uniform_int_distribution<int> small{4, 64};
+	std::uniform_int_distribution<int> large{256, 2048};
+	std::uniform_int_distribution<int> pick{0, 99};
+
+	std::vector<SDL::Rect> rects;
+	rects.reserve(count);
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		auto& size = pick(rng) == 0 ? large : small;
+		rects.push_back({{pos(rng), pos(rng)}, {size(rng), size(rng)}});
+	}
+	return rects;
+}
+
+template<typename Index>
+void queryBenchmarks(Runner& runner, std::string const& prefix, std::string const& name, Index const& index,
+	std::vector<SDL::Point> const& points, std::vector<SDL::Rect> const& areas, std::size_t expected)
+{
+	std::vector<std::uint32_t> out;
+	std::size_t found = 0;
+	if (auto r = runner.run(prefix + "/point/" + name, [&]
+	{
+		found = 0;
+		for (auto p: points)
+		{
+			out.clear();
+			found += index.query(p, out);
+		}
+		return std::uint64_t{points.size()};
+	}))
+	{
+		r->metrics["results per query"] = static_cast<double>(found) / static_cast<double>(points.size());
+	}
+
+	std::size_t matched = 0;
+	if (auto r = runner.run(prefix + "/rect/" + name, [&]
+	{
+		matched = 0;
+		for (auto const& a: areas)
+		{
+			out.clear();
+			matched += index.query(a, out);
+		}
+		return std::uint64_t{areas.size()};
+	}))
+	{
+		r->metrics["matches linear scan"] = expected == 0 or matched == expected;
+	}
+}
+}
+
+void spatialBenchmarks(Runner& runner, Context&)
+{
+	for (std::size_t count: {10'000, 100'000, 1'000'000})
+	{
+		auto prefix = "spatial/" + std::to_string(count);
+		if (not runner.wants(prefix))
+		{
+			continue;
+		}
+
+		std::mt19937 rng{7};
+		auto rects = makeRects(count, rng);
+		std::uniform_int_distribution<int> pos{0, world.s.w - 1};
+		std::vector<SDL::Point> points;
+		std::vector<SDL::Rect> areas;
+		for (int i = 0; i < queries; ++i)
+		{
+			points.push_back({pos(rng), pos(rng)});
+			areas.push_back({{pos(rng), pos(rng)}, {512, 512}});
+		}
+
+		LinearScan linear{rects};
+		SDL::SpatialGrid grid{world, {128, 128}};
+		SDL::LooseQuadtree tree{world, 9};
+		for (auto const& r: rects)
+		{
+			grid.insert(r);
+			tree.insert(r);
+		}
+
+		std::vector<std::uint32_t> out;
+		std::size_t expected = 0;
+		for (auto const& a: areas)
+		{
+			expected += linear.query(a, out);
+		}
+
+		queryBenchmarks(runner, prefix, "linear", linear, points, areas, expected);
+		queryBenchmarks(runner, prefix, "grid", grid, points, areas, expected);
+		queryBenchmarks(runner, prefix, "quadtree", tree, points, areas, expected);
+
+		// small moves, as widgets and sprites make from frame to frame
+		std::uniform_int_distribution<std::uint32_t> pickId{0, static_cast<std::uint32_t>(count - 1)};
+		std::uniform_int_distribution<int> step{-4, 4};
+		auto nudge = [&](auto& index)
+		{
+			for (int i = 0; i < queries; ++i)
+			{
+				auto id = pickId(rng);
+				auto r = index.get(id);
+				r.p.x += step(rng);
+				r.p.y += step(rng);
+				index.move(id, r);
+			}
+			return std::uint64_t{queries};
+		};
+		runner.run(prefix + "/move/grid", [&] { return nudge(grid); });
+		runner.run(prefix + "/move/quadtree", [&] { return nudge(tree); });
+	}
+}
+}
@@ -0,0 +1,174 @@
+#include "bench.h"
+
+#include <string>
+#include <vector>
+
+#include "sdlpp/pixel.h"
+#include "sdlpp/pixelops.h"
+#include "sdlpp/surface.h"
+#include "sdlpp/surfacepool.h"
+#include "sdlpp/video.h"
+
+namespace Bench
+{
+namespace
+{
+constexpr SDL::Size big{1024, 1024};
+constexpr SDL::Size sprite{256, 256};
+
+std::uint64_t pixels(SDL::Size s)
+{
+	return static_cast<std::uint64_t>(s.w) * static_cast<std::uint64_t>(s.h);
+}
+
+char const* isaName(SDL::PixelOps::Isa isa)
+{
+	switch (isa)
+	{
+		case SDL::PixelOps::Isa::Scalar: return "scalar";
+		case SDL::PixelOps::Isa::SSE2: return "sse2";
+		case SDL::PixelOps::Isa::AVX2: return "avx2";
+	}
+	return "unknown";
+}
+}
+
+void surfaceBenchmarks(Runner& runner, Context& context)
+{
+	SDL::Surface dst{big};
+	SDL::Surface src{sprite};
+	src.fillRect({{0, 0}, sprite}, SDL::Color{0x80, 0x40, 0x20, 0x80});
+	SDL::Color const opaque{0x20, 0x40, 0x80};
+	SDL::Color const translucent{0x20, 0x40, 0x80, 0x80};
+
+	// SDL's own software paths, as a reference for the PixelOps kernels
+	runner.run("sdl/fill_rect", [&]
+	{
+		SDL_FillRect(dst.get(), nullptr, SDL_MapRGBA(dst.get()->format, opaque.r, opaque.g, opaque.b, opaque.a));
+		return pixels(big);
+	});
+	runner.run("sdl/blit_blend", [&]
+	{
+		SDL_SetSurfaceBlendMode(src.get(), SDL_BLENDMODE_BLEND);
+		SDL_Rect r{0, 0, sprite.w, sprite.h};
+		SDL_BlitSurface(src.get(), nullptr, dst.get(), &r);
+		return pixels(sprite);
+	});
+	runner.run("surface/blit", [&]
+	{
+		dst.blit(src, {0, 0});
+		return pixels(sprite);
+	});
+
+	auto supported = SDL::PixelOps::supportedIsa();
+	for (auto isa: {SDL::PixelOps::Isa::Scalar, SDL::PixelOps::Isa::SSE2, SDL::PixelOps::Isa::AVX2})
+	{
+		if (isa > supported)
+		{
+			runner.skip(std::string{"surface/"} + isaName(isa), "not supported by this CPU");
+			continue;
+		}
+		SDL::PixelOps::setIsa(isa);
+		auto suffix = std::string{"/"} + isaName(isa);
+
+		runner.run("surface/fill_rect" + suffix, [&]
+		{
+			dst.fillRect({{0, 0}, big}, opaque);
+			return pixels(big);
+		});
+		runner.run("surface/blend_rect" + suffix, [&]
+		{
+			dst.blendRect({{0, 0}, big}, translucent);
+			return pixels(big);
+		});
+		runner.run("surface/blit_premultiplied" + suffix, [&]
+		{
+			dst.blitPremultiplied(src, {0, 0});
+			return pixels(sprite);
+		});
+		runner.run("surface/blit_color_key" + suffix, [&]
+		{
+			dst.blitColorKey(src, opaque, {0, 0});
+			return pixels(sprite);
+		});
+	}
+	SDL::PixelOps::setIsa(supported);
+
+	// per-pixel access: putPixel vs a PixelView held for the whole pass
+	runner.run("surface/put_pixel", [&]
+	{
+		for (int y = 0; y < sprite.h; ++y)
+		{
+			for (int x = 0; x < sprite.w; ++x)
+			{
+				src.putPixel({x, y}, opaque);
+			}
+		}
+		return pixels(sprite);
+	});
+	runner.run("surface/pixel_view", [&]
+	{
+		auto view = src.lockPixels();
+		auto p = view.map(opaque);
+		for (auto row: view.rows())
+		{
+			for (auto& px: row)
+			{
+				px = p;
+			}
+		}
+		return pixels(sprite);
+	});
+
+	// keeping a texture in sync after a small change
+	auto& renderer = context.renderer;
+	dst.getTexture(renderer);
+	int frame = 0;
+	runner.run("surface/texture_update/dirty_rect", [&]
+	{
+		dst.fillRect({{(frame++ * 16) % big.w, 0}, {16, 16}}, opaque);
+		keep(dst.getTexture(renderer));
+		return std::uint64_t{1};
+	});
+	runner.run("surface/texture_update/recreate", [&]
+	{
+		dst.fillRect({{(frame++ * 16) % big.w, 0}, {16, 16}}, opaque);
+		auto texture = SDL_CreateTextureFromSurface(renderer.get(), dst.get());
+		SDL_DestroyTexture(texture);
+		return std::uint64_t{1};
+	});
+
+	// scratch surfaces: fresh allocations vs the pool and a per-frame arena
+	runner.run("surface/create", [&]
+	{
+		for (int i = 0; i < 16; ++i)
+		{
+			keep(SDL::Surface{sprite});
+		}
+		return std::uint64_t{16};
+	});
+	SDL::SurfacePool pool;
+	if (auto r = runner.run("surface_pool/acquire", [&]
+	{
+		for (int i = 0; i < 16; ++i)
+		{
+			keep(pool.acquire(sprite));
+		}
+		return std::uint64_t{16};
+	}))
+	{
+		auto stats = pool.getStats();
+		r->metrics["reuse rate"] = static_cast<double>(stats.reuses) / static_cast<double>(stats.reuses + stats.allocations);
+	}
+	SDL::SurfaceArena arena{pool};
+	runner.run("surface_arena/frame", [&]
+	{
+		for (int i = 0; i < 16; ++i)
+		{
+			arena.make(sprite);
+		}
+		arena.reset();
+		return std::uint64_t{16};
+	});
+}
+}
@@ -0,0 +1,141 @@
+#include "bench.h"
+
+#include <array>
+#include <string>
+
+#include <SDL2/SDL_ttf.h>
+
+#include "sdlpp/error.h"
+#include "sdlpp/font.h"
+#include "sdlpp/glyphatlas.h"
+#include "sdlpp/surface.h"
+#include "sdlpp/textcache.h"
+#include "sdlpp/video.h"
+
+namespace Bench
+{
+namespace
+{
+std::array<char const*, 8> const labels{
+	"Score", "Lives", "Level 1", "Paused", "Press any key",
+	"Options", "Quit", "The quick brown fox jumps over the lazy dog",
+};
+
+std::array<int, 8> const sizes{10, 12, 14, 16, 20, 24, 32, 48};
+}
+
+void textBenchmarks(Runner& runner, Context& context)
+{
+	if (not context.font)
+	{
+		for (auto name: {"font/", "text_cache/", "glyph_atlas/"})
+		{
+			runner.skip(name, "no font, pass --font or set SDLPP_BENCH_FONT");
+		}
+		return;
+	}
+
+	auto path = context.font->string();
+	auto& renderer = context.renderer;
+	SDL::Font font{path};
+	SDL::Color const white{0xFF, 0xFF, 0xFF};
+
+	runner.run("font/render/short", [&]
+	{
+		keep(font.render("Hello, world", 16, white));
+		return std::uint64_t{1};
+	});
+	runner.run("font/render/long", [&]
+	{
+		keep(font.render(labels.back(), 16, white));
+		return std::uint64_t{1};
+	});
+	runner.run("font/render_wrapped", [&]
+	{
+		keep(font.renderWrapped(labels.back(), 16, 120, white));
+		return std::uint64_t{1};
+	});
+	runner.run("font/layout", [&]
+	{
+		keep(font.layout(labels.back(), 16));
+		return std::uint64_t{1};
+	});
+
+	// one label per frame the old way: rasterize, upload and draw it every time
+	runner.run("text/render_and_copy", [&]
+	{
+		for (auto label: labels)
+		{
+			renderer.copySurface(font.render(label, 16, white), {10, 10});
+		}
+		return std::uint64_t{labels.size()};
+	});
+
+	SDL::TextCache cache{font, renderer, 4 << 20};
+	if (auto r = runner.run("text_cache/render_and_copy/hit", [&]
+	{
+		for (auto label: labels)
+		{
+			renderer.copySurface(cache.render(label, 16, white), {10, 10});
+		}
+		return std::uint64_t{labels.size()};
+	}))
+	{
+		auto stats = cache.getStats();
+		r->metrics["hit rate"] = static_cast<double>(stats.hits) / static_cast<double>(stats.hits + stats.misses);
+	}
+
+	std::uint64_t counter = 0;
+	cache.resetCounters();
+	if (auto r = runner.run("text_cache/render/miss", [&]
+	{
+		keep(cache.render(std::to_string(counter++), 16, white));
+		return std::uint64_t{1};
+	}))
+	{
+		r->metrics["evictions per item"] = static_cast<double>(cache.getStats().evictions) / static_cast<double>(r->items);
+	}
+
+	SDL::GlyphAtlas glyphs{font, renderer};
+	for (auto batched: {false, true})
+	{
+		renderer.setBatching(batched);
+		runner.run(std::string{"glyph_atlas/draw_text"} + (batched ? "/batched" : "/immediate"), [&]
+		{
+			for (auto label: labels)
+			{
+				renderer.drawText(glyphs, label, 16, {10, 10}, white);
+			}
+			renderer.flush();
+			return std::uint64_t{labels.size()};
+		});
+	}
+	renderer.setBatching(false);
+
+	// opening a font at several sizes: a file open per size vs one in-memory copy
+	runner.run("font/open_sizes/ttf_per_size", [&]
+	{
+		for (auto size: sizes)
+		{
+			auto f = TTF_OpenFont(path.c_str(), size);
+			if (f == nullptr)
+			{
+				throw SDL::Error{TTF_GetError()};
+			}
+			int advance;
+			TTF_GlyphMetrics32(f, 'a', nullptr, nullptr, nullptr, nullptr, &advance);
+			TTF_CloseFont(f);
+		}
+		return std::uint64_t{sizes.size()};
+	});
+	runner.run("font/open_sizes/memory", [&]
+	{
+		SDL::Font f{path, sizes.front()};
+		for (auto size: sizes)
+		{
+			keep(f.glyphMetrics('a', size));
+		}
+		return std::uint64_t{sizes.size()};
+	});
+}
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace SDL
+{
+class Surface;
+
+/* A read-only pack of named assets, memory-mapped as a whole.
+ *
+ * Layout (little endian):
+ *   header   "SDLPPAK1", u32 version, u32 entry count, u64 index offset
+ *   data     entry payloads, each aligned to 16 bytes
+ *   index    per entry: u64 offset, u64 size, u32 kind, u32 pixel format,
+ *            u32 width, u32 height, u32 pitch, u32 name length, name bytes
+ *
+ * Raw entries hold files as they were (PNG, TTF, ...). Pixel entries hold
+ * images already decoded to a 32-bit SDL pixel format, so loading them is a
+ * copy rather than a decode. Entries stay valid as long as the archive. */
+class Archive
+{
+	public:
+		enum class Kind: std::uint32_t
+		{
+			Raw,
+			Pixels,
+		};
+
+		struct Entry
+		{
+			std::string_view name;
+			Kind kind;
+			std::span<std::byte const> data;
+
+			// pixel entries only
+			std::uint32_t format;
+			int width;
+			int height;
+			int pitch;
+		};
+
+		Archive(std::filesystem::path const& fname);
+
+		Archive(Archive const&) = delete;
+		Archive& operator=(Archive const&) = delete;
+
+		Archive(Archive&& other) noexcept;
+		Archive& operator=(Archive&& other) noexcept;
+
+		~Archive() noexcept;
+
+		// nullptr if there is no such entry
+		Entry const* find(std::string_view name) const noexcept;
+		// throws Error if there is no such entry
+		Entry const& at(std::string_view name) const;
+
+		std::span<Entry const> entries() const noexcept;
+
+	private:
+		void release() noexcept;
+		void parse();
+
+		std::byte const* mapping = nullptr;
+		std::size_t length = 0;
+
+		std::vector<Entry> list;
+		std::unordered_map<std::string_view, std::size_t> index;  // names point into the mapping
+};
+
+// collects assets in memory and writes them out as an Archive
+class ArchiveWriter
+{
+	public:
+		void add(std::string name, std::span<std::byte const> data);
+		void addFile(std::string name, std::filesystem::path const& fname);
+		// converts to ARGB8888 unless the surface is already 32-bit
+		void addPixels(std::string name, Surface const& surface);
+
+		void write(std::filesystem::path const& fname) const;
+
+	private:
+		struct Pending
+		{
+			std::string name;
+			Archive::Kind kind;
+			std::vector<std::byte> data;
+			std::uint32_t format = 0;
+			std::uint32_t width = 0;
+			std::uint32_t height = 0;
+			std::uint32_t pitch = 0;
+		};
+
+		std::vector<Pending> pending;
+};
+}
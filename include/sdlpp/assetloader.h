@@ -0,0 +1,79 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "sdlpp/font.h"
+#include "sdlpp/surface.h"
+
+namespace SDL
+{
+class Renderer;
+
+/* Decodes images and opens fonts on a pool of worker threads.
+ *
+ * Renderers are single-threaded, so a decoded surface is handed back to the
+ * render thread and only becomes ready once drainUploads() has created its
+ * texture. Fonts need no renderer and are ready as soon as they are opened.
+ * The workers open fonts one at a time, but nothing else may open or close a
+ * font (including new sizes of an existing one) while a font load is pending.
+ * Failures are reported through the future as Error.
+ *
+ * Destroying the loader stops the workers; futures of loads that had not
+ * finished yet report std::future_error (broken_promise). */
+class AssetLoader
+{
+	public:
+		AssetLoader(Renderer& renderer, unsigned int threads=std::thread::hardware_concurrency());
+
+		AssetLoader(AssetLoader const&) = delete;
+		AssetLoader& operator=(AssetLoader const&) = delete;
+
+		~AssetLoader() noexcept;
+
+		std::future<Surface> loadSurface(std::filesystem::path fname);
+		std::future<Font> loadFont(std::string fname, int ptsize=16);
+
+		/* Called once per frame on the render thread: creates textures for
+		 * decoded surfaces until the budget is spent, at least one per call so
+		 * that loading always makes progress. Returns the number uploaded. */
+		std::size_t drainUploads(std::chrono::microseconds budget);
+
+		// loads that have not reached the upload queue yet
+		std::size_t pendingLoads() const;
+		std::size_t pendingUploads() const;
+
+	private:
+		struct Upload
+		{
+			Surface surface;
+			std::shared_ptr<std::promise<Surface>> promise;  // shared with the job until queued
+		};
+
+		void enqueue(std::function<void()> job);
+		void work(std::stop_token stop);
+
+		Renderer& renderer;
+
+		mutable std::mutex jobMutex;
+		std::condition_variable_any jobReady;
+		std::deque<std::function<void()>> jobs;
+		std::size_t running = 0;
+
+		mutable std::mutex uploadMutex;
+		std::deque<Upload> uploads;
+
+		std::vector<std::jthread> workers;  // last, so they are joined before the queues go away
+};
+}
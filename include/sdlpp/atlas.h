@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include <SDL2/SDL.h>
+
+#include "sdlpp/geometry.h"
+#include "sdlpp/surface.h"
+
+namespace SDL
+{
+class Renderer;
+
+class Atlas;
+
+struct AtlasHandle
+{
+	Atlas const* atlas = nullptr;
+	std::uint32_t id = 0;
+	std::uint32_t generation = 0;  // tells a stale handle from one to a later entry with the same id
+
+	constexpr bool operator==(AtlasHandle const& other) const noexcept = default;
+};
+
+/* Packs many small surfaces into a few large page textures so that drawing
+ * them does not rebind a texture per sprite. Pages are packed with a skyline
+ * (bottom-left) packer; erased entries leave holes that are reclaimed when a
+ * page empties completely or on repack(). Handles stay valid across repacks;
+ * once erased, a handle is stale: it draws nothing and has an empty rect, even
+ * after its id was reused.
+ *
+ * The page textures belong to the renderer: if it is destroyed first, they
+ * went with it and the atlas only releases its surfaces. */
+class Atlas
+{
+	public:
+		Atlas(Renderer& renderer, Size pageSize=Size{1024, 1024}, int padding=1);
+
+		Atlas(Atlas const&) = delete;
+		Atlas& operator=(Atlas const&) = delete;
+
+		~Atlas() noexcept;
+
+		AtlasHandle insert(Surface const& s);
+		void erase(AtlasHandle h) noexcept;
+		void repack();
+
+		bool contains(AtlasHandle h) const noexcept;  // false for stale handles
+		SDL_Texture* getTexture(AtlasHandle h) const noexcept;  // nullptr for stale handles
+		Rect getRect(AtlasHandle h) const noexcept;
+
+		std::size_t pageCount() const noexcept;
+		double occupancy() const noexcept;  // live entry area / total page area
+
+	private:
+		struct SkylineNode
+		{
+			int x;
+			int y;
+			int w;
+		};
+
+		struct Page
+		{
+			Surface pixels;
+			SDL_Texture* texture = nullptr;
+			std::vector<SkylineNode> skyline;
+			long usedArea = 0;
+			std::uint32_t entries = 0;
+		};
+
+		struct Entry
+		{
+			std::uint32_t page;
+			Rect rect;
+			bool alive;
+			std::uint32_t generation;
+		};
+
+		Page& addPage(std::vector<Page>& into);
+		void resetSkyline(Page& page) const;
+		std::optional<Point> allocate(Page& page, Size s) const;
+		int fit(Page const& page, std::size_t index, Size s) const noexcept;
+		std::uint32_t place(std::vector<Page>& into, Size s, Point& where);
+		void upload(Page& page, Rect r);
+		void destroyTextures(std::vector<Page>& of) noexcept;
+
+		Renderer& renderer;
+		std::weak_ptr<void const> alive;  // expires with the renderer (and the page textures)
+		Size pageSize;
+		int padding;
+
+		std::vector<Page> pages;
+		std::vector<Entry> entries;
+		std::vector<std::uint32_t> freeIds;
+};
+}
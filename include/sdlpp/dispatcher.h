@@ -0,0 +1,54 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <vector>
+
+#include "sdlpp/events.h"
+
+namespace SDL
+{
+/* Routes events to handlers through flat tables indexed by event type and,
+ * optionally, window id, instead of every consumer switching on each event.
+ * Runs of consecutive events of the same type are handed to batch handlers
+ * as a single span. Handlers must not subscribe while a dispatch is running. */
+class EventDispatcher
+{
+	public:
+		using Handler = std::function<void(Event const&)>;
+		using BatchHandler = std::function<void(std::span<Event const>)>;
+
+		void subscribe(EventType type, Handler handler);
+		void subscribe(EventType type, std::uint32_t windowId, Handler handler);
+		void subscribeBatch(EventType type, BatchHandler handler);
+
+		void dispatch(Event const& ev);
+		void dispatch(std::span<Event const> evs);
+
+		/* Pops what was queued when called, at most max events, without
+		 * blocking, and dispatches it. Events pushed meanwhile are left for
+		 * the next call, so busy producers cannot stall a frame. */
+		std::size_t drain(EventQueue& queue, std::size_t max=SIZE_MAX);
+
+	private:
+		static constexpr std::size_t typeCount = static_cast<std::size_t>(EventType::NotImplemented) + 1;
+
+		template<typename T>
+		using Table = std::array<std::vector<T>, typeCount>;
+
+		static constexpr std::size_t index(EventType type) noexcept
+		{
+			return static_cast<std::size_t>(type);
+		}
+
+		void dispatchRun(std::span<Event const> run);
+
+		Table<Handler> byType;
+		Table<BatchHandler> batchByType;
+		std::vector<Table<Handler>> byWindow;  // indexed by window id, ids are small and dense
+
+		std::vector<Event> drained;  // reused by drain()
+};
+}
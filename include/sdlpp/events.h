@@ -1,26 +1,58 @@
 #pragma once
 
-#include <condition_variable>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
 #include <cstdint>
-#include <mutex>
-#include <variant>
-#include <queue>
+#include <cstring>
+#include <iterator>
+#include <new>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
 
 #include <SDL2/SDL.h>
 
+#include "sdlpp/error.h"
 #include "sdlpp/geometry.h"
+#include "sdlpp/profiler.h"
+#include "sdlpp/ringqueue.h"
 
 namespace SDL
 {
-enum class ButtonState
+enum class ButtonState: std::uint8_t
 {
 	Pressed, Released
 };
 
+// SDL_Keysym without its unused padding field
+struct Keysym
+{
+	SDL_Scancode scancode;
+	SDL_Keycode sym;
+	std::uint16_t mod;
+
+	Keysym(SDL_Keysym k) noexcept
+		: scancode{k.scancode}
+		, sym{k.sym}
+		, mod{k.mod}
+	{}
+
+	operator SDL_Keysym() const noexcept
+	{
+		return {scancode, sym, mod, 0};
+	}
+};
+
 struct KeyboardEvent
 {
 	std::uint32_t windowId;
-	SDL_Keysym keysym;
+	Keysym keysym;
 
 	ButtonState state;
 	bool isRepeat;
@@ -43,7 +75,7 @@ struct KeyboardEvent
 	}
 };
 
-enum class MouseButton
+enum class MouseButton: std::uint8_t
 {
 	Left, Middle, Right, X1, X2
 };
@@ -104,7 +136,7 @@ struct MouseButtonEvent
 struct QuitEvent
 {};
 
-enum class WindowEventType
+enum class WindowEventType: std::uint8_t
 {
 	WindowShown, WindowHidden,
 	WindowExposed,
@@ -188,7 +220,228 @@ struct WindowResizedEvent
 	{}
 };
 
-enum class EventType
+constexpr ButtonState toButtonState(std::uint8_t state) noexcept
+{
+	return state == SDL_PRESSED ? ButtonState::Pressed : ButtonState::Released;
+}
+
+struct TextEditingEvent
+{
+	std::uint32_t windowId;
+	std::string_view text;
+	std::int32_t start;
+	std::int32_t length;
+
+	TextEditingEvent(SDL_TextEditingEvent const& ev) noexcept
+		: windowId{ev.windowID}
+		, text{ev.text}
+		, start{ev.start}
+		, length{ev.length}
+	{}
+};
+
+struct TextInputEvent
+{
+	std::uint32_t windowId;
+	std::string_view text;
+
+	TextInputEvent(SDL_TextInputEvent const& ev) noexcept
+		: windowId{ev.windowID}
+		, text{ev.text}
+	{}
+};
+
+// button state is not carried to keep the event compact, track MouseButtonEvents instead
+struct MouseMotionEvent
+{
+	std::uint32_t windowId;
+	std::uint32_t mouseId;
+
+	Point p;
+	Vec2D rel;
+
+	MouseMotionEvent(SDL_MouseMotionEvent ev) noexcept
+		: windowId{ev.windowID}
+		, mouseId{ev.which}
+		, p{ev.x, ev.y}
+		, rel{ev.xrel, ev.yrel}
+	{}
+};
+
+struct MouseWheelEvent
+{
+	std::uint32_t windowId;
+	std::uint32_t mouseId;
+
+	Vec2D scroll;  // positive y is away from the user, positive x to the right
+	bool flipped;
+
+	MouseWheelEvent(SDL_MouseWheelEvent ev) noexcept
+		: windowId{ev.windowID}
+		, mouseId{ev.which}
+		, scroll{ev.x, ev.y}
+		, flipped{ev.direction == SDL_MOUSEWHEEL_FLIPPED}
+	{}
+};
+
+struct JoyAxisEvent
+{
+	SDL_JoystickID joystickId;
+	std::uint8_t axis;
+	std::int16_t value;
+
+	JoyAxisEvent(SDL_JoyAxisEvent ev) noexcept
+		: joystickId{ev.which}
+		, axis{ev.axis}
+		, value{ev.value}
+	{}
+};
+
+struct JoyBallEvent
+{
+	SDL_JoystickID joystickId;
+	std::uint8_t ball;
+	Vec2D rel;
+
+	JoyBallEvent(SDL_JoyBallEvent ev) noexcept
+		: joystickId{ev.which}
+		, ball{ev.ball}
+		, rel{ev.xrel, ev.yrel}
+	{}
+};
+
+struct JoyHatEvent
+{
+	SDL_JoystickID joystickId;
+	std::uint8_t hat;
+	std::uint8_t value;  // SDL_HAT_* bitmask
+
+	JoyHatEvent(SDL_JoyHatEvent ev) noexcept
+		: joystickId{ev.which}
+		, hat{ev.hat}
+		, value{ev.value}
+	{}
+};
+
+struct JoyButtonEvent
+{
+	SDL_JoystickID joystickId;
+	std::uint8_t button;
+	ButtonState state;
+
+	JoyButtonEvent(SDL_JoyButtonEvent ev) noexcept
+		: joystickId{ev.which}
+		, button{ev.button}
+		, state{toButtonState(ev.state)}
+	{}
+};
+
+struct ControllerAxisEvent
+{
+	SDL_JoystickID joystickId;
+	std::uint8_t axis;  // SDL_GameControllerAxis
+	std::int16_t value;
+
+	ControllerAxisEvent(SDL_ControllerAxisEvent ev) noexcept
+		: joystickId{ev.which}
+		, axis{ev.axis}
+		, value{ev.value}
+	{}
+};
+
+struct ControllerButtonEvent
+{
+	SDL_JoystickID joystickId;
+	std::uint8_t button;  // SDL_GameControllerButton
+	ButtonState state;
+
+	ControllerButtonEvent(SDL_ControllerButtonEvent ev) noexcept
+		: joystickId{ev.which}
+		, button{ev.button}
+		, state{toButtonState(ev.state)}
+	{}
+};
+
+// device index for *DeviceAdded, instance id for *DeviceRemoved and *DeviceRemapped
+struct DeviceEvent
+{
+	std::int32_t which;
+
+	DeviceEvent(std::int32_t which_) noexcept
+		: which{which_}
+	{}
+};
+
+struct TouchFingerEvent
+{
+	std::uint32_t windowId;
+	SDL_TouchID touchId;
+	SDL_FingerID fingerId;
+
+	// normalized to [0, 1] (deltas to [-1, 1])
+	float x;
+	float y;
+	float dx;
+	float dy;
+	float pressure;
+
+	TouchFingerEvent(SDL_TouchFingerEvent const& ev) noexcept
+		: windowId{ev.windowID}
+		, touchId{ev.touchId}
+		, fingerId{ev.fingerId}
+		, x{ev.x}
+		, y{ev.y}
+		, dx{ev.dx}
+		, dy{ev.dy}
+		, pressure{ev.pressure}
+	{}
+};
+
+struct DollarGestureEvent
+{
+	SDL_TouchID touchId;
+	SDL_GestureID gestureId;
+	std::uint32_t numFingers;
+	float error;
+	float x;
+	float y;
+
+	DollarGestureEvent(SDL_DollarGestureEvent const& ev) noexcept
+		: touchId{ev.touchId}
+		, gestureId{ev.gestureId}
+		, numFingers{ev.numFingers}
+		, error{ev.error}
+		, x{ev.x}
+		, y{ev.y}
+	{}
+};
+
+struct MultiGestureEvent
+{
+	SDL_TouchID touchId;
+	float dTheta;
+	float dDist;
+	float x;
+	float y;
+	std::uint16_t numFingers;
+
+	MultiGestureEvent(SDL_MultiGestureEvent const& ev) noexcept
+		: touchId{ev.touchId}
+		, dTheta{ev.dTheta}
+		, dDist{ev.dDist}
+		, x{ev.x}
+		, y{ev.y}
+		, numFingers{ev.numFingers}
+	{}
+};
+
+struct DropEvent
+{
+	std::uint32_t windowId;
+	std::string_view file;
+};
+
+enum class EventType: std::uint8_t
 {
 	Quit,
 	/* Android & iOS events */
@@ -222,90 +475,735 @@ enum class EventType
 	NotImplemented
 };
 
-struct Event
+/* Events are 32 bytes, two per cache line, and cheap to copy or move. The
+ * payload of common events is stored inline; rare or large events (text,
+ * touch, gestures, drops, user and unknown events) keep a copy of the full
+ * SDL_Event out of line. */
+class Event
 {
-	static Event fromSdlEvent(SDL_Event ev)
-	{
-		auto timestamp = ev.common.timestamp;
-		switch (ev.type)
+	public:
+		static Event fromSdlEvent(SDL_Event ev)
 		{
-			case SDL_KEYUP:
-				return {EventType::KeyUp, timestamp, KeyboardEvent{ev.key}};
-			case SDL_KEYDOWN:
-				return {EventType::KeyDown, timestamp, KeyboardEvent{ev.key}};
+			auto timestamp = ev.common.timestamp;
+			switch (ev.type)
+			{
+				case SDL_QUIT:
+					return {EventType::Quit, timestamp, QuitEvent{}};
+
+				case SDL_APP_TERMINATING:
+					return {EventType::AppTerminating, timestamp};
+				case SDL_APP_LOWMEMORY:
+					return {EventType::AppLowMemory, timestamp};
+				case SDL_APP_WILLENTERBACKGROUND:
+					return {EventType::AppWillEnterBackground, timestamp};
+				case SDL_APP_DIDENTERBACKGROUND:
+					return {EventType::AppDidEnterBackground, timestamp};
+				case SDL_APP_WILLENTERFOREGROUND:
+					return {EventType::AppWillEnterForeground, timestamp};
+				case SDL_APP_DIDENTERFOREGROUND:
+					return {EventType::AppDidEnterForeground, timestamp};
+
+				case SDL_WINDOWEVENT:
+					switch (ev.window.event)
+					{
+						case SDL_WINDOWEVENT_MOVED:
+							return {EventType::WindowMoved, timestamp, WindowMovedEvent{ev.window}};
+						case SDL_WINDOWEVENT_RESIZED:
+							return {EventType::WindowResized, timestamp, WindowResizedEvent{ev.window}};
+						default:
+							return {EventType::WindowEvent, timestamp, WindowEvent{ev.window}};
+					}
 
-			case SDL_MOUSEBUTTONUP:
-				return {EventType::MouseButtonUp, timestamp, MouseButtonEvent{ev.button}};
-			case SDL_MOUSEBUTTONDOWN:
-				return {EventType::MouseButtonDown, timestamp, MouseButtonEvent{ev.button}};
+				case SDL_KEYUP:
+					return {EventType::KeyUp, timestamp, KeyboardEvent{ev.key}};
+				case SDL_KEYDOWN:
+					return {EventType::KeyDown, timestamp, KeyboardEvent{ev.key}};
+				case SDL_TEXTEDITING:
+					return {EventType::TextEditing, timestamp, ev};
+				case SDL_TEXTINPUT:
+					return {EventType::TextInput, timestamp, ev};
 
-			case SDL_QUIT:
-				return {EventType::Quit, timestamp, QuitEvent{}};
+				case SDL_MOUSEMOTION:
+					return {EventType::MouseMotion, timestamp, MouseMotionEvent{ev.motion}};
+				case SDL_MOUSEBUTTONUP:
+					return {EventType::MouseButtonUp, timestamp, MouseButtonEvent{ev.button}};
+				case SDL_MOUSEBUTTONDOWN:
+					return {EventType::MouseButtonDown, timestamp, MouseButtonEvent{ev.button}};
+				case SDL_MOUSEWHEEL:
+					return {EventType::MouseWheel, timestamp, MouseWheelEvent{ev.wheel}};
 
-			case SDL_WINDOWEVENT:
-				switch (ev.window.event)
+				case SDL_JOYAXISMOTION:
+					return {EventType::JoyAxisMotion, timestamp, JoyAxisEvent{ev.jaxis}};
+				case SDL_JOYBALLMOTION:
+					return {EventType::JoyBallMotion, timestamp, JoyBallEvent{ev.jball}};
+				case SDL_JOYHATMOTION:
+					return {EventType::JoyHatMotion, timestamp, JoyHatEvent{ev.jhat}};
+				case SDL_JOYBUTTONDOWN:
+					return {EventType::JoyButtonDown, timestamp, JoyButtonEvent{ev.jbutton}};
+				case SDL_JOYBUTTONUP:
+					return {EventType::JoyButtonUp, timestamp, JoyButtonEvent{ev.jbutton}};
+				case SDL_JOYDEVICEADDED:
+					return {EventType::JoyDeviceAdded, timestamp, DeviceEvent{ev.jdevice.which}};
+				case SDL_JOYDEVICEREMOVED:
+					return {EventType::JoyDeviceRemoved, timestamp, DeviceEvent{ev.jdevice.which}};
+
+				case SDL_CONTROLLERAXISMOTION:
+					return {EventType::ControllerAxisMotion, timestamp, ControllerAxisEvent{ev.caxis}};
+				case SDL_CONTROLLERBUTTONDOWN:
+					return {EventType::ControllerButtonDown, timestamp, ControllerButtonEvent{ev.cbutton}};
+				case SDL_CONTROLLERBUTTONUP:
+					return {EventType::ControllerButtonUp, timestamp, ControllerButtonEvent{ev.cbutton}};
+				case SDL_CONTROLLERDEVICEADDED:
+					return {EventType::ControllerDeviceAdded, timestamp, DeviceEvent{ev.cdevice.which}};
+				case SDL_CONTROLLERDEVICEREMOVED:
+					return {EventType::ControllerDeviceRemoved, timestamp, DeviceEvent{ev.cdevice.which}};
+				case SDL_CONTROLLERDEVICEREMAPPED:
+					return {EventType::ControllerDeviceRemapped, timestamp, DeviceEvent{ev.cdevice.which}};
+
+				case SDL_FINGERDOWN:
+					return {EventType::FingerDown, timestamp, ev};
+				case SDL_FINGERUP:
+					return {EventType::FingerUp, timestamp, ev};
+				case SDL_FINGERMOTION:
+					return {EventType::FingerMotion, timestamp, ev};
+
+				case SDL_DOLLARGESTURE:
+					return {EventType::DollarGesture, timestamp, ev};
+				case SDL_DOLLARRECORD:
+					return {EventType::DollarRecord, timestamp, ev};
+				case SDL_MULTIGESTURE:
+					return {EventType::MultiGesture, timestamp, ev};
+
+				case SDL_CLIPBOARDUPDATE:
+					return {EventType::ClipboardUpdate, timestamp};
+
+				case SDL_DROPFILE:
+				case SDL_DROPTEXT:
+				case SDL_DROPBEGIN:
+				case SDL_DROPCOMPLETE:
 				{
-					case SDL_WINDOWEVENT_MOVED:
-						return {EventType::WindowMoved, timestamp, WindowMovedEvent{ev.window}};
-					case SDL_WINDOWEVENT_RESIZED:
-						return {EventType::WindowResized, timestamp, WindowResizedEvent{ev.window}};
-					default:
-						return {EventType::WindowEvent, timestamp, WindowEvent{ev.window}};
+					// SDL hands over ownership of the file name, take a copy and free it
+					std::string file = ev.drop.file != nullptr ? ev.drop.file : "";
+					SDL_free(ev.drop.file);
+					ev.drop.file = nullptr;
+					auto type = ev.type == SDL_DROPFILE ? EventType::DropFile : EventType::NotImplemented;
+					return {type, timestamp, ev, std::move(file)};
 				}
-			default:
-				return {EventType::NotImplemented, timestamp, ev};
+
+				default:
+					if (ev.type >= SDL_USEREVENT and ev.type < SDL_LASTEVENT)
+					{
+						return {EventType::UserEvent, timestamp, ev};
+					}
+					return {EventType::NotImplemented, timestamp, ev};
+			}
 		}
-	}
 
-	KeyboardEvent key() const
-	{
-		return std::get<KeyboardEvent>(event);
-	}
+		/* The two constructors below are for event types stored inline; the
+		 * others (see isOutOfLine) own a copy of the SDL_Event and must be made
+		 * from one, so they are rejected here. */
+		Event(EventType type_, std::uint32_t timestamp_)
+			: type{type_}
+			, timestamp{timestamp_}
+		{
+			std::memset(storage, 0, sizeof(storage));
+			expectInline(type);
+		}
 
-	MouseButtonEvent mouseButton() const
-	{
-		return std::get<MouseButtonEvent>(event);
-	}
+		template<typename Payload>
+		Event(EventType type_, std::uint32_t timestamp_, Payload const& payload)
+			: type{type_}
+			, timestamp{timestamp_}
+		{
+			static_assert(std::is_trivially_copyable_v<Payload>);
+			static_assert(sizeof(Payload) <= sizeof(storage) and alignof(Payload) <= alignof(Event));
+			std::memset(storage, 0, sizeof(storage));
+			expectInline(type);
+			::new (static_cast<void*>(storage)) Payload(payload);
+		}
+
+		// for the out-of-line types only, inline ones are rejected
+		Event(EventType type_, std::uint32_t timestamp_, SDL_Event const& raw, std::string text={})
+			: type{type_}
+			, timestamp{timestamp_}
+		{
+			expectOutOfLine(type);
+			setLarge(new Large{raw, std::move(text)});
+		}
+
+		Event(Event const& other)
+			: type{other.type}
+			, timestamp{other.timestamp}
+		{
+			copyPayload(other);
+		}
+
+		Event(Event&& other) noexcept
+			: type{other.type}
+			, timestamp{other.timestamp}
+		{
+			std::memcpy(storage, other.storage, sizeof(storage));
+			other.type = EventType::Quit;  // payload-less, nothing left to release
+		}
+
+		Event& operator=(Event const& other)
+		{
+			if (this != &other)
+			{
+				release();
+				type = other.type;
+				timestamp = other.timestamp;
+				copyPayload(other);
+			}
+			return *this;
+		}
+
+		Event& operator=(Event&& other) noexcept
+		{
+			if (this != &other)
+			{
+				release();
+				type = other.type;
+				timestamp = other.timestamp;
+				std::memcpy(storage, other.storage, sizeof(storage));
+				other.type = EventType::Quit;
+			}
+			return *this;
+		}
+
+		~Event() noexcept
+		{
+			release();
+		}
+
+		static constexpr bool isOutOfLine(EventType type) noexcept
+		{
+			switch (type)
+			{
+				case EventType::TextEditing:
+				case EventType::TextInput:
+				case EventType::FingerDown:
+				case EventType::FingerUp:
+				case EventType::FingerMotion:
+				case EventType::DollarGesture:
+				case EventType::DollarRecord:
+				case EventType::MultiGesture:
+				case EventType::DropFile:
+				case EventType::UserEvent:
+				case EventType::NotImplemented:
+					return true;
+				default:
+					return false;
+			}
+		}
+
+		/* Folds a later event of the same kind from the same device into this
+		 * one: positions and axis values take the newest value, relative
+		 * motion accumulates. Returns false if the events cannot be merged. */
+		bool coalesce(Event const& next) noexcept
+		{
+			if (next.type != type)
+			{
+				return false;
+			}
+
+			switch (type)
+			{
+				case EventType::MouseMotion:
+				{
+					auto& m = payload<MouseMotionEvent>();
+					auto const& n = next.payload<MouseMotionEvent>();
+					if (m.windowId != n.windowId or m.mouseId != n.mouseId)
+					{
+						return false;
+					}
+					m.p = n.p;
+					m.rel = m.rel + n.rel;
+					break;
+				}
+
+				case EventType::JoyAxisMotion:
+				{
+					auto& m = payload<JoyAxisEvent>();
+					auto const& n = next.payload<JoyAxisEvent>();
+					if (m.joystickId != n.joystickId or m.axis != n.axis)
+					{
+						return false;
+					}
+					m.value = n.value;
+					break;
+				}
+
+				case EventType::JoyBallMotion:
+				{
+					auto& m = payload<JoyBallEvent>();
+					auto const& n = next.payload<JoyBallEvent>();
+					if (m.joystickId != n.joystickId or m.ball != n.ball)
+					{
+						return false;
+					}
+					m.rel = m.rel + n.rel;
+					break;
+				}
+
+				case EventType::ControllerAxisMotion:
+				{
+					auto& m = payload<ControllerAxisEvent>();
+					auto const& n = next.payload<ControllerAxisEvent>();
+					if (m.joystickId != n.joystickId or m.axis != n.axis)
+					{
+						return false;
+					}
+					m.value = n.value;
+					break;
+				}
+
+				case EventType::FingerMotion:
+				{
+					auto& m = getLarge()->raw.tfinger;
+					auto const& n = next.getLarge()->raw.tfinger;
+					if (m.touchId != n.touchId or m.fingerId != n.fingerId)
+					{
+						return false;
+					}
+					m.x = n.x;
+					m.y = n.y;
+					m.dx += n.dx;
+					m.dy += n.dy;
+					m.pressure = n.pressure;
+					break;
+				}
+
+				default:
+					return false;
+			}
+
+			timestamp = next.timestamp;
+			return true;
+		}
+
+		static constexpr bool isCoalescable(EventType type) noexcept
+		{
+			return type == EventType::MouseMotion
+				or type == EventType::JoyAxisMotion or type == EventType::JoyBallMotion
+				or type == EventType::ControllerAxisMotion
+				or type == EventType::FingerMotion;
+		}
+
+		// 0 (never a valid window id) for events not tied to a window
+		std::uint32_t windowId() const noexcept
+		{
+			switch (type)
+			{
+				case EventType::WindowMoved:
+					return payload<WindowMovedEvent>().windowId;
+				case EventType::WindowResized:
+					return payload<WindowResizedEvent>().windowId;
+				case EventType::WindowEvent:
+					return payload<WindowEvent>().windowId;
+				case EventType::KeyDown:
+				case EventType::KeyUp:
+					return payload<KeyboardEvent>().windowId;
+				case EventType::MouseMotion:
+					return payload<MouseMotionEvent>().windowId;
+				case EventType::MouseButtonDown:
+				case EventType::MouseButtonUp:
+					return payload<MouseButtonEvent>().windowId;
+				case EventType::MouseWheel:
+					return payload<MouseWheelEvent>().windowId;
+				case EventType::TextEditing:
+					return getLarge()->raw.edit.windowID;
+				case EventType::TextInput:
+					return getLarge()->raw.text.windowID;
+				case EventType::FingerDown:
+				case EventType::FingerUp:
+				case EventType::FingerMotion:
+					return getLarge()->raw.tfinger.windowID;
+				case EventType::DropFile:
+					return getLarge()->raw.drop.windowID;
+				default:
+					return 0;
+			}
+		}
 
-	EventType type;
-	std::uint32_t timestamp;
-
-	using EventVariant = std::variant<
-		KeyboardEvent,
-		MouseButtonEvent,
-		QuitEvent,
-		WindowEvent,
-		WindowMovedEvent,
-		WindowResizedEvent,
-		SDL_Event
-	>;
-	EventVariant event;
+		KeyboardEvent const& key() const
+		{
+			expect(type == EventType::KeyDown or type == EventType::KeyUp);
+			return payload<KeyboardEvent>();
+		}
+
+		TextEditingEvent textEditing() const
+		{
+			expect(type == EventType::TextEditing);
+			return {getLarge()->raw.edit};
+		}
+
+		TextInputEvent textInput() const
+		{
+			expect(type == EventType::TextInput);
+			return {getLarge()->raw.text};
+		}
+
+		MouseMotionEvent const& mouseMotion() const
+		{
+			expect(type == EventType::MouseMotion);
+			return payload<MouseMotionEvent>();
+		}
+
+		MouseButtonEvent const& mouseButton() const
+		{
+			expect(type == EventType::MouseButtonDown or type == EventType::MouseButtonUp);
+			return payload<MouseButtonEvent>();
+		}
+
+		MouseWheelEvent const& mouseWheel() const
+		{
+			expect(type == EventType::MouseWheel);
+			return payload<MouseWheelEvent>();
+		}
+
+		JoyAxisEvent const& joyAxis() const
+		{
+			expect(type == EventType::JoyAxisMotion);
+			return payload<JoyAxisEvent>();
+		}
+
+		JoyBallEvent const& joyBall() const
+		{
+			expect(type == EventType::JoyBallMotion);
+			return payload<JoyBallEvent>();
+		}
+
+		JoyHatEvent const& joyHat() const
+		{
+			expect(type == EventType::JoyHatMotion);
+			return payload<JoyHatEvent>();
+		}
+
+		JoyButtonEvent const& joyButton() const
+		{
+			expect(type == EventType::JoyButtonDown or type == EventType::JoyButtonUp);
+			return payload<JoyButtonEvent>();
+		}
+
+		ControllerAxisEvent const& controllerAxis() const
+		{
+			expect(type == EventType::ControllerAxisMotion);
+			return payload<ControllerAxisEvent>();
+		}
+
+		ControllerButtonEvent const& controllerButton() const
+		{
+			expect(type == EventType::ControllerButtonDown or type == EventType::ControllerButtonUp);
+			return payload<ControllerButtonEvent>();
+		}
+
+		DeviceEvent const& device() const
+		{
+			expect(type == EventType::JoyDeviceAdded or type == EventType::JoyDeviceRemoved
+				or type == EventType::ControllerDeviceAdded or type == EventType::ControllerDeviceRemoved
+				or type == EventType::ControllerDeviceRemapped);
+			return payload<DeviceEvent>();
+		}
+
+		TouchFingerEvent finger() const
+		{
+			expect(type == EventType::FingerDown or type == EventType::FingerUp or type == EventType::FingerMotion);
+			return {getLarge()->raw.tfinger};
+		}
+
+		DollarGestureEvent dollarGesture() const
+		{
+			expect(type == EventType::DollarGesture or type == EventType::DollarRecord);
+			return {getLarge()->raw.dgesture};
+		}
+
+		MultiGestureEvent multiGesture() const
+		{
+			expect(type == EventType::MultiGesture);
+			return {getLarge()->raw.mgesture};
+		}
+
+		DropEvent drop() const
+		{
+			expect(type == EventType::DropFile);
+			return {getLarge()->raw.drop.windowID, getLarge()->text};
+		}
+
+		SDL_UserEvent const& user() const
+		{
+			expect(type == EventType::UserEvent);
+			return getLarge()->raw.user;
+		}
+
+		WindowEvent const& window() const
+		{
+			expect(type == EventType::WindowEvent);
+			return payload<WindowEvent>();
+		}
+
+		WindowMovedEvent const& windowMoved() const
+		{
+			expect(type == EventType::WindowMoved);
+			return payload<WindowMovedEvent>();
+		}
+
+		WindowResizedEvent const& windowResized() const
+		{
+			expect(type == EventType::WindowResized);
+			return payload<WindowResizedEvent>();
+		}
+
+		SDL_Event const& raw() const
+		{
+			expect(isOutOfLine(type));
+			return getLarge()->raw;
+		}
+
+		EventType type;
+		std::uint32_t timestamp;
+
+	private:
+		struct Large
+		{
+			SDL_Event raw;
+			std::string text;  // owned copy of strings SDL hands over (drop events)
+		};
+
+		alignas(8) std::byte storage[24];
+
+		static void expect(bool holds)
+		{
+			if (not holds)
+			{
+				throw Error{"Event does not hold the requested payload"};
+			}
+		}
+
+		static void expectInline(EventType type)
+		{
+			if (isOutOfLine(type))
+			{
+				throw Error{"Event type needs the SDL_Event it was translated from"};
+			}
+		}
+
+		static void expectOutOfLine(EventType type)
+		{
+			if (not isOutOfLine(type))
+			{
+				throw Error{"Event type is stored inline, not as an SDL_Event"};
+			}
+		}
+
+		template<typename Payload>
+		Payload const& payload() const noexcept
+		{
+			return *std::launder(reinterpret_cast<Payload const*>(storage));
+		}
+
+		template<typename Payload>
+		Payload& payload() noexcept
+		{
+			return *std::launder(reinterpret_cast<Payload*>(storage));
+		}
+
+		Large* getLarge() const noexcept
+		{
+			Large* large;
+			std::memcpy(&large, storage, sizeof(large));
+			return large;
+		}
+
+		void setLarge(Large* large) noexcept
+		{
+			std::memcpy(storage, &large, sizeof(large));
+		}
+
+		void copyPayload(Event const& other)
+		{
+			if (isOutOfLine(other.type))
+			{
+				setLarge(new Large(*other.getLarge()));
+			}
+			else
+			{
+				std::memcpy(storage, other.storage, sizeof(storage));
+			}
+		}
+
+		void release() noexcept
+		{
+			if (isOutOfLine(type))
+			{
+				delete getLarge();
+			}
+		}
 };
 
+static_assert(sizeof(Event) == 32);
+
+struct PumpStats
+{
+	std::size_t events = 0;
+	std::size_t coalesced = 0;  // events folded into earlier ones, not published
+	bool deferred = false;  // the queue was full, the remaining events wait for the next call
+	std::chrono::nanoseconds duration{0};
+};
+
+/* Lock-free event queue: any number of threads may push, one thread pops.
+ * push and push_many wait for the consumer to make room when the queue is
+ * full, so they are for producers on other threads only; pumpEvents never
+ * waits and may be called from the consuming thread. */
 class EventQueue
 {
 	public:
-		void pumpEvents()
+		explicit EventQueue(std::size_t capacity=4096)
+			: queue_{capacity}
+			, rawChunk(pumpChunk)
+		{
+			chunk.reserve(pumpChunk);
+		}
+
+		/* Drains SDL in chunks and publishes each converted chunk with a single
+		 * reservation in the queue. Takes about as many events from SDL as the
+		 * queue has room for. When it is full, stats.deferred is set and the
+		 * rest waits for the next call: in SDL, or for events already taken
+		 * from it, in a pending buffer that is published before anything else.
+		 * No event is ever lost. Must only be called from one thread at a time
+		 * (normally the main thread, as SDL requires). */
+		PumpStats pumpEvents()
 		{
-			SDL_Event ev;
-			while (SDL_PollEvent(&ev) != 0)
+			auto start = std::chrono::steady_clock::now();
+			PumpStats stats;
+
+			SDL_PumpEvents();
+			while (publishPending())
 			{
-				push(Event::fromSdlEvent(ev));
+				// only an estimate, whatever does not fit stays pending
+				auto room = std::min(queue_.capacity() - queue_.size(), rawChunk.size());
+				if (room == 0)
+				{
+					stats.deferred = true;
+					break;
+				}
+
+				auto n = SDL_PeepEvents(rawChunk.data(), static_cast<int>(room), SDL_GETEVENT, SDL_FIRSTEVENT, SDL_LASTEVENT);
+				if (n < 0)
+				{
+					throw Error{SDL_GetError()};
+				}
+				if (n == 0)
+				{
+					break;
+				}
+
+				chunk.clear();
+				published = 0;
+				coalesceFrom = 0;
+				for (int i = 0; i < n; ++i)
+				{
+					auto ev = Event::fromSdlEvent(rawChunk[i]);
+					if (coalescing and coalesceIntoChunk(ev))
+					{
+						++stats.coalesced;
+						continue;
+					}
+					chunk.push_back(std::move(ev));
+				}
+				stats.events += static_cast<std::size_t>(n);
+
+				if (static_cast<std::size_t>(n) < room)
+				{
+					publishPending();
+					break;
+				}
 			}
+			stats.deferred = stats.deferred or published < chunk.size();
+
+			stats.duration = std::chrono::steady_clock::now() - start;
+			lastPump = stats;
+			SDLPP_PROFILE_COUNT(EventsPumped, stats.events);
+			return stats;
+		}
+
+		/* When enabled, pumping merges motion and axis events of the same device
+		 * (mouse, joystick axis or ball, controller axis, finger) that arrive in
+		 * the same chunk without any other kind of event in between. */
+		void setCoalescing(bool enabled) noexcept
+		{
+			coalescing = enabled;
+		}
+
+		PumpStats lastPumpStats() const noexcept
+		{
+			return lastPump;
 		}
 
 		Event wait_pop()
 		{
-			std::unique_lock<std::mutex> pin{m};
-			cv.wait(pin, [this]{ return not empty(); });
-			return pop_unsafe();
+			// spin briefly first: handing off to a busy producer is cheaper than sleeping
+			for (int i = 0; i < spinLimit; ++i)
+			{
+				if (auto ev = queue_.try_pop())
+				{
+					return std::move(*ev);
+				}
+			}
+
+			while (true)
+			{
+				waiters.fetch_add(1, std::memory_order_relaxed);
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				auto seen = signal.load(std::memory_order_acquire);
+				auto ev = queue_.try_pop();
+				if (not ev)
+				{
+					signal.wait(seen, std::memory_order_acquire);
+					ev = queue_.try_pop();
+				}
+				waiters.fetch_sub(1, std::memory_order_relaxed);
+				if (ev)
+				{
+					return std::move(*ev);
+				}
+			}
+		}
+
+		std::optional<Event> try_pop()
+		{
+			return queue_.try_pop();
 		}
 
+		// appends up to max events to out without blocking, returns how many
+		std::size_t pop_many(std::vector<Event>& out, std::size_t max)
+		{
+			return queue_.try_pop_many(std::back_inserter(out), max);
+		}
+
+		// waits while the queue is full, never call from the consuming thread
 		void push(Event ev)
 		{
-			std::unique_lock<std::mutex> pin{m};
-			queue_.push(ev);
-			cv.notify_all();
+			while (not queue_.try_push(std::move(ev)))
+			{
+				std::this_thread::yield();
+			}
+			wake();
+		}
+
+		void push_many(std::span<Event> evs)
+		{
+			while (not evs.empty())
+			{
+				auto pushed = queue_.try_push_many(evs.begin(), evs.size());
+				if (pushed == 0)
+				{
+					std::this_thread::yield();
+					continue;
+				}
+				evs = evs.subspan(pushed);
+				wake();
+			}
 		}
 
 		bool empty() const
@@ -313,17 +1211,69 @@ class EventQueue
 			return queue_.empty();
 		}
 
+		// an estimate when other threads push or pop at the same time
+		std::size_t size() const noexcept
+		{
+			return queue_.size();
+		}
+
 	private:
-		mutable std::mutex m;
-		std::condition_variable cv;
+		static constexpr int spinLimit = 256;
 
-		Event pop_unsafe()
+		// publishes what is left of the pump chunk, returns whether all of it is
+		bool publishPending()
 		{
-			auto ev = queue_.front();
-			queue_.pop();
-			return ev;
+			auto rest = chunk.begin() + static_cast<std::ptrdiff_t>(published);
+			auto pushed = queue_.try_push_many(rest, chunk.size() - published);
+			if (pushed > 0)
+			{
+				wake();
+			}
+			published += pushed;
+			return published == chunk.size();
 		}
 
-		std::queue<Event> queue_;
+		bool coalesceIntoChunk(Event const& ev) noexcept
+		{
+			if (not Event::isCoalescable(ev.type))
+			{
+				coalesceFrom = chunk.size() + 1;  // nothing may be merged across this event
+				return false;
+			}
+			for (auto i = chunk.size(); i > coalesceFrom; --i)
+			{
+				if (chunk[i - 1].coalesce(ev))
+				{
+					return true;
+				}
+			}
+			return false;
+		}
+
+		void wake()
+		{
+			// pairs with the fence in wait_pop: either the waiter sees the event or we see the waiter
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			if (waiters.load(std::memory_order_relaxed) > 0)
+			{
+				signal.fetch_add(1, std::memory_order_release);
+				signal.notify_all();
+			}
+		}
+
+		RingQueue<Event> queue_;
+		std::atomic<int> waiters{0};
+
+		// pump buffers, reused between calls
+		static constexpr std::size_t pumpChunk = 128;
+		std::vector<SDL_Event> rawChunk;
+		std::vector<Event> chunk;
+		std::size_t published = 0;  // chunk[published..] was taken from SDL but is not in the queue yet
+		PumpStats lastPump;
+
+		bool coalescing = false;
+		std::size_t coalesceFrom = 0;
+
+		std::atomic<std::uint32_t> signal{0};
 };
 }
@@ -1,22 +1,57 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <mutex>
+#include <vector>
 
 #include <SDL2/SDL_ttf.h>
 
+#include "sdlpp/geometry.h"
+
 namespace SDL
 {
+class Archive;
+
 struct Color;
 
 class Surface;
 
+struct GlyphMetrics
+{
+	int minx;
+	int maxx;
+	int miny;
+	int maxy;
+	int advance;
+};
+
+struct GlyphQuad
+{
+	char32_t codepoint;
+	Rect dst;  // relative to the top-left corner of the first line
+};
+
+// identifies a rendered glyph, for caches keyed by both codepoint and size
+constexpr std::uint64_t glyphKey(char32_t codepoint, int ptsize) noexcept
+{
+	return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(ptsize)) << 32) | codepoint;
+}
+
 // FIXME switch from SDL_TTF to another library
 class Font
 {
 	public:
 		Font(std::string file, int ptsize=16);
+		// the data is not copied and must outlive the font
+		Font(std::span<std::byte const> data, int ptsize=16);
+		// reads straight from the mapping, the archive must outlive the font
+		Font(Archive const& archive, std::string_view name, int ptsize=16);
 
 		Font(Font const&) = delete;
 		Font& operator=(Font const&) = delete;
@@ -29,12 +64,31 @@ class Font
 		Surface render(std::string text, int ptsize, Color color) const;
 		Surface renderWrapped(std::string text, int ptsize, unsigned int width, Color color) const;
 
+		/* Glyphs are rasterized once per (ptsize, codepoint), in white so that
+		 * they can be tinted when drawn, and kept for the lifetime of the font. */
+		Surface const& renderGlyph(char32_t codepoint, int ptsize) const;
+		GlyphMetrics glyphMetrics(char32_t codepoint, int ptsize) const;
+
+		/* Positions the glyphs of a UTF-8 string, honouring kerning and newlines.
+		 * Glyphs without ink (e.g. spaces) only advance the pen. */
+		void layout(std::string_view text, int ptsize, std::vector<GlyphQuad>& out) const;
+		std::vector<GlyphQuad> layout(std::string_view text, int ptsize) const;
+
 	private:
-		std::string file;  // need to reopen for a different ptsize
-		// TODO FIXME figure out how to use SDL_RWops to read from disk into memory instead
+		std::vector<std::byte> storage;  // file contents, read once for all sizes
+		std::span<std::byte const> data;
 
 		mutable std::unordered_map<int, TTF_Font*> fonts;
-		void addSize(int ptsize) const;
+		// opens the size on first use; the map is only read under the mutex
+		TTF_Font* addSize(int ptsize) const;
+
+		struct Glyph
+		{
+			GlyphMetrics metrics;
+			std::unique_ptr<Surface> surface;  // rasterized on first use
+		};
+		mutable std::unordered_map<std::uint64_t, Glyph> glyphs;
+		Glyph& getGlyph(char32_t codepoint, int ptsize) const;
 
 		void release() noexcept;
 
@@ -2,6 +2,7 @@
 
 #include <algorithm>
 #include <optional>
+#include <stdexcept>
 
 #include <SDL2/SDL.h>
 
@@ -275,6 +276,15 @@ struct Rect
 	{
 		return {p.x, p.y, s.w, s.h};
 	}
+
+	// true if the rects share at least one pixel, empty rects intersect nothing
+	constexpr bool intersects(Rect other) const noexcept;
+
+	// the part inside area, with zero size if there is none
+	constexpr Rect clipped(Rect area) const noexcept;
+
+	// the smallest rect covering both, empty rects are ignored
+	constexpr Rect united(Rect other) const noexcept;
 };
 
 constexpr bool Point::in(Rect r) const noexcept
@@ -283,4 +293,37 @@ constexpr bool Point::in(Rect r) const noexcept
 	auto dy = y - r.p.y;
 	return (dx >= 0) && (dx < r.s.w) && (dy >= 0) && (dy < r.s.h);
 }
+
+constexpr bool Rect::intersects(Rect other) const noexcept
+{
+	return p.x < other.p.x + other.s.w && other.p.x < p.x + s.w
+		&& p.y < other.p.y + other.s.h && other.p.y < p.y + s.h
+		&& s.w > 0 && s.h > 0 && other.s.w > 0 && other.s.h > 0;
+}
+
+constexpr Rect Rect::clipped(Rect area) const noexcept
+{
+	auto x0 = std::max(p.x, area.p.x);
+	auto y0 = std::max(p.y, area.p.y);
+	auto x1 = std::min(p.x + s.w, area.p.x + area.s.w);
+	auto y1 = std::min(p.y + s.h, area.p.y + area.s.h);
+	return {{x0, y0}, {std::max(x1 - x0, 0), std::max(y1 - y0, 0)}};
+}
+
+constexpr Rect Rect::united(Rect other) const noexcept
+{
+	if (other.s.w <= 0 or other.s.h <= 0)
+	{
+		return *this;
+	}
+	if (s.w <= 0 or s.h <= 0)
+	{
+		return other;
+	}
+	auto x0 = std::min(p.x, other.p.x);
+	auto y0 = std::min(p.y, other.p.y);
+	auto x1 = std::max(p.x + s.w, other.p.x + other.s.w);
+	auto y1 = std::max(p.y + s.h, other.p.y + other.s.h);
+	return {{x0, y0}, {x1 - x0, y1 - y0}};
+}
 }
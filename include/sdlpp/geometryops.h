@@ -0,0 +1,172 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "sdlpp/geometry.h"
+
+namespace SDL::GeometryOps
+{
+/* Batch versions of the Rect and Point operations in geometry.h, working on
+ * coordinates stored as separate arrays (one per field) so that they can be
+ * processed several at a time. Every function gives exactly the results of
+ * the scalar operation it names, element by element. They run on the
+ * instruction set selected with PixelOps::setIsa.
+ *
+ * The number of elements processed is the smallest of the spans' sizes.
+ * An output span may be the same as an input span, but must not otherwise
+ * overlap it. */
+struct PointSpan
+{
+	std::span<int> x;
+	std::span<int> y;
+};
+
+struct ConstPointSpan
+{
+	std::span<int const> x;
+	std::span<int const> y;
+
+	ConstPointSpan(std::span<int const> x_, std::span<int const> y_) noexcept: x{x_}, y{y_} {}
+	ConstPointSpan(PointSpan s) noexcept: x{s.x}, y{s.y} {}
+};
+
+struct RectSpan
+{
+	std::span<int> x;
+	std::span<int> y;
+	std::span<int> w;
+	std::span<int> h;
+};
+
+struct ConstRectSpan
+{
+	std::span<int const> x;
+	std::span<int const> y;
+	std::span<int const> w;
+	std::span<int const> h;
+
+	ConstRectSpan(std::span<int const> x_, std::span<int const> y_, std::span<int const> w_, std::span<int const> h_) noexcept
+		: x{x_}, y{y_}, w{w_}, h{h_}
+	{}
+	ConstRectSpan(RectSpan s) noexcept: x{s.x}, y{s.y}, w{s.w}, h{s.h} {}
+};
+
+// owning storage for the spans above
+class PointArray
+{
+	public:
+		void push_back(Point p)
+		{
+			x.push_back(p.x);
+			y.push_back(p.y);
+		}
+
+		Point operator[](std::size_t i) const noexcept
+		{
+			return {x[i], y[i]};
+		}
+
+		std::size_t size() const noexcept
+		{
+			return x.size();
+		}
+
+		void resize(std::size_t n)
+		{
+			x.resize(n);
+			y.resize(n);
+		}
+
+		void clear() noexcept
+		{
+			x.clear();
+			y.clear();
+		}
+
+		operator PointSpan() noexcept
+		{
+			return {x, y};
+		}
+
+		operator ConstPointSpan() const noexcept
+		{
+			return {x, y};
+		}
+
+		std::vector<int> x;
+		std::vector<int> y;
+};
+
+class RectArray
+{
+	public:
+		void push_back(Rect r)
+		{
+			x.push_back(r.p.x);
+			y.push_back(r.p.y);
+			w.push_back(r.s.w);
+			h.push_back(r.s.h);
+		}
+
+		Rect operator[](std::size_t i) const noexcept
+		{
+			return {{x[i], y[i]}, {w[i], h[i]}};
+		}
+
+		std::size_t size() const noexcept
+		{
+			return x.size();
+		}
+
+		void resize(std::size_t n)
+		{
+			x.resize(n);
+			y.resize(n);
+			w.resize(n);
+			h.resize(n);
+		}
+
+		void clear() noexcept
+		{
+			x.clear();
+			y.clear();
+			w.clear();
+			h.clear();
+		}
+
+		operator RectSpan() noexcept
+		{
+			return {x, y, w, h};
+		}
+
+		operator ConstRectSpan() const noexcept
+		{
+			return {x, y, w, h};
+		}
+
+		std::vector<int> x;
+		std::vector<int> y;
+		std::vector<int> w;
+		std::vector<int> h;
+};
+
+// out[i] = Rect(anchors[i].p, anchors[i].s, align)
+void alignRects(ConstRectSpan anchors, Alignment align, RectSpan out) noexcept;
+// out[i] = rects[i].alignedPoint(align)
+void alignedPoints(ConstRectSpan rects, Alignment align, PointSpan out) noexcept;
+
+// out[i] = points[i].in(r), returns how many are inside
+std::size_t containsPoints(Rect r, ConstPointSpan points, std::span<std::uint8_t> out) noexcept;
+// out[i] = p.in(rects[i]), returns how many contain p
+std::size_t rectsContaining(ConstRectSpan rects, Point p, std::span<std::uint8_t> out) noexcept;
+// out[i] = rects[i].intersects(r), returns how many intersect
+std::size_t intersectRects(ConstRectSpan rects, Rect r, std::span<std::uint8_t> out) noexcept;
+
+// Rect{{0, 0}, {0, 0}}.united(rects[0]).united(rects[1])...
+Rect unionBounds(ConstRectSpan rects) noexcept;
+// out[i] = rects[i].clipped(area)
+void clipRects(ConstRectSpan rects, Rect area, RectSpan out) noexcept;
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "sdlpp/atlas.h"
+#include "sdlpp/font.h"
+
+namespace SDL
+{
+class Renderer;
+
+/* Per-renderer atlas of the glyphs of one font. Once every glyph of a string
+ * has been seen, drawing it needs neither rasterization nor new textures. */
+class GlyphAtlas
+{
+	public:
+		GlyphAtlas(Font const& font, Renderer& renderer, Size pageSize=Size{512, 512});
+
+		AtlasHandle get(char32_t codepoint, int ptsize);
+
+		// the returned span is valid until the next call
+		std::span<GlyphQuad const> layout(std::string_view text, int ptsize);
+
+	private:
+		Font const& font;
+		Atlas atlas;
+		std::unordered_map<std::uint64_t, AtlasHandle> handles;
+		std::vector<GlyphQuad> quads;
+};
+}
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "sdlpp/geometry.h"
+
+namespace SDL
+{
+/* A retained tree of layout nodes producing a Rect for each of them.
+ *
+ * Every node is a container: a box overlays its children, a stack places them
+ * one after another along an axis, and a grid places them row by row in a
+ * fixed number of columns. A node without children is sized by its content
+ * size (the measured text, image, ...) plus padding. Sizes are constrained
+ * with OptionalSize, an unset axis meaning unconstrained: size fixes an axis,
+ * maxSize bounds it, and nothing is larger than the space its parent offers.
+ * A node is placed in the slot its parent gives it according to its
+ * alignment, or fills the slot if it stretches.
+ *
+ * Changes only mark the node and its ancestors dirty, and update() then
+ * remeasures and rearranges just those. A clean subtree whose size did not
+ * change is moved without being visited, since rects are kept relative to the
+ * parent. Ids are reused after removal; using an id that was removed, or
+ * never added, throws Error. */
+class Layout
+{
+	public:
+		using Id = std::uint32_t;
+
+		enum class Direction: std::uint8_t
+		{
+			Horizontal, Vertical,
+		};
+
+		struct Stats
+		{
+			std::size_t measured = 0;  // nodes whose size was recomputed in the last update
+			std::size_t relaid = 0;  // nodes whose children were placed again
+		};
+
+		// parent is nullopt for a root, roots are laid out in the whole viewport
+		Id addBox(std::optional<Id> parent);
+		Id addStack(std::optional<Id> parent, Direction direction, int spacing=0);
+		Id addGrid(std::optional<Id> parent, int columns, int spacing=0);
+		void remove(Id id);  // with its children
+
+		void setSize(Id id, OptionalSize size);
+		void setMinSize(Id id, Size size);
+		void setMaxSize(Id id, OptionalSize size);
+		void setContentSize(Id id, Size size);
+		void setAlignment(Id id, Alignment align);
+		void setPadding(Id id, int padding);
+		void setStretch(Id id, bool stretch);
+
+		// forces the next update to lay out every node from scratch
+		void invalidate() noexcept;
+		void update(Size viewport);
+
+		Rect getRect(Id id) const;  // in viewport coordinates, as of the last update
+		std::size_t size() const noexcept;
+		Stats getStats() const noexcept;
+
+	private:
+		enum class Kind: std::uint8_t
+		{
+			Box, Stack, Grid,
+		};
+
+		static constexpr Id none = 0xFFFFFFFF;
+
+		struct Node
+		{
+			Kind kind = Kind::Box;
+			Direction direction = Direction::Horizontal;
+			int spacing = 0;
+			int columns = 1;
+
+			Id parent = none;
+			std::vector<Id> children;
+
+			OptionalSize size;
+			Size minSize{0, 0};
+			OptionalSize maxSize;
+			Size contentSize{0, 0};
+			Alignment align = Alignment::TopLeft;
+			int padding = 0;
+			bool stretch = false;
+
+			// results of the last update
+			OptionalSize measuredFor;  // the space offered to the last measure
+			Size desired{0, 0};
+			std::vector<int> tracks;  // grids: column widths, then row heights
+			Rect local{{0, 0}, {0, 0}};  // relative to the parent
+
+			bool alive = true;
+			bool measured = false;
+			bool fitted = false;  // nothing in the subtree was cut down to the space offered
+			bool placed = false;
+			bool dirty = true;  // the ancestors of a dirty node are dirty too
+		};
+
+		Node& at(Id id);
+		Node const& at(Id id) const;
+		Id add(std::optional<Id> parent, Node node);
+		void markDirty(Id id) noexcept;
+		template<typename T>
+		void change(Id id, T Node::* field, T value);
+
+		Size measure(Id id, OptionalSize available);
+		void arrange(Id id, Rect slot);
+
+		std::vector<Node> nodes;
+		std::vector<Id> freeIds;
+		std::vector<Id> roots;
+		Stats stats;
+};
+}
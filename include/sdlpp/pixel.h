@@ -33,6 +33,8 @@ struct Color
 		return {r, g, b, a};
 	}
 
+	constexpr bool operator==(Color const& other) const noexcept = default;
+
 	static Color const Black;
 	static Color const Blue;
 	static Color const Green;
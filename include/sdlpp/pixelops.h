@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+
+namespace SDL::PixelOps
+{
+/* Row kernels for 32-bit pixels with 8-bit channels and alpha in the most
+ * significant byte (the layout of surfaces from createSurface on little-endian
+ * machines, and of ARGB8888). The widest instruction set the CPU supports is
+ * picked at startup; the scalar versions are always available. */
+enum class Isa: std::uint8_t
+{
+	Scalar, SSE2, AVX2,
+};
+
+Isa supportedIsa() noexcept;
+Isa activeIsa() noexcept;
+void setIsa(Isa isa) noexcept;  // clamped to what the CPU supports
+
+void fill(std::span<std::uint32_t> dst, std::uint32_t pixel) noexcept;
+// straight (non-premultiplied) alpha blend of a constant color over dst
+void blendFill(std::span<std::uint32_t> dst, std::uint32_t pixel) noexcept;
+// premultiplied alpha-over: dst = src + dst * (1 - src.a)
+void blitOver(std::span<std::uint32_t> dst, std::span<std::uint32_t const> src) noexcept;
+// copies src pixels whose color (ignoring alpha) differs from key
+void blitColorKey(std::span<std::uint32_t> dst, std::span<std::uint32_t const> src, std::uint32_t key) noexcept;
+// swaps the first and third channels, RGBA <-> BGRA; dst may alias src
+void swizzleRedBlue(std::span<std::uint32_t> dst, std::span<std::uint32_t const> src) noexcept;
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+/* Instrumentation hooks. With SDLPP_PROFILING undefined (the sdlpp_noprofile
+ * library) they compile to nothing and the counters simply stay at zero. */
+#ifdef SDLPP_PROFILING
+#define SDLPP_PROFILE_CONCAT_(a, b) a##b
+#define SDLPP_PROFILE_CONCAT(a, b) SDLPP_PROFILE_CONCAT_(a, b)
+#define SDLPP_PROFILE_COUNT(counter, n) ::SDL::Profiler::count(::SDL::Profiler::Counter::counter, n)
+#define SDLPP_PROFILE_ZONE(name) ::SDL::Profiler::Zone SDLPP_PROFILE_CONCAT(sdlppZone, __LINE__){name}
+#define SDLPP_PROFILE_PRESENT() ::SDL::Profiler::PresentScope SDLPP_PROFILE_CONCAT(sdlppPresent, __LINE__)
+#else
+#define SDLPP_PROFILE_COUNT(counter, n) ((void)0)
+#define SDLPP_PROFILE_ZONE(name) ((void)0)
+#define SDLPP_PROFILE_PRESENT() ((void)0)
+#endif
+
+namespace SDL::Profiler
+{
+enum class Counter: std::uint8_t
+{
+	DrawCalls,
+	TextureCreations,
+	TextureUploads,
+	TextureDestructions,
+	FontRasterizations,
+	EventsPumped,
+};
+inline constexpr std::size_t counterCount = 6;
+
+char const* getName(Counter c) noexcept;
+
+struct FrameStats
+{
+	std::uint64_t frame = 0;
+	std::array<std::uint64_t, counterCount> counters{};
+	std::chrono::nanoseconds presentTime{0};
+	std::chrono::nanoseconds frameTime{0};  // from the previous present to the end of this one
+
+	std::uint64_t operator[](Counter c) const noexcept
+	{
+		return counters[static_cast<std::size_t>(c)];
+	}
+};
+
+// thread-safe, may be called from any thread
+void count(Counter c, std::uint64_t n=1) noexcept;
+
+/* Closes the current frame, called by Renderer::present. Counters from all
+ * threads are attributed to the frame they were incremented in. */
+void endFrame(std::chrono::nanoseconds presentTime) noexcept;
+
+FrameStats lastFrame() noexcept;
+// every closed frame summed, frame is the number of frames
+FrameStats totals() noexcept;
+void reset() noexcept;
+
+// times its scope as the present of the current frame, then closes the frame
+class PresentScope
+{
+	public:
+		PresentScope() noexcept;
+
+		PresentScope(PresentScope const&) = delete;
+		PresentScope& operator=(PresentScope const&) = delete;
+
+		~PresentScope() noexcept;
+
+	private:
+		std::chrono::steady_clock::time_point start;
+};
+
+/* Records a complete ("X") trace event for its scope while tracing is on.
+ * Use SDLPP_PROFILE_ZONE rather than this directly. */
+class Zone
+{
+	public:
+		explicit Zone(char const* name) noexcept;
+
+		Zone(Zone const&) = delete;
+		Zone& operator=(Zone const&) = delete;
+
+		~Zone() noexcept;
+
+	private:
+		char const* name;  // must be a string literal
+		std::chrono::steady_clock::time_point start;
+		bool active;
+};
+
+/* Tracing collects zones and per-frame counters in memory until it is
+ * stopped; writeTrace emits them in the Chrome trace event format, which
+ * chrome://tracing and Perfetto load directly. */
+void startTrace();
+void stopTrace() noexcept;
+bool isTracing() noexcept;
+void writeTrace(std::filesystem::path const& fname);
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <memory>
+
+#include <SDL2/SDL.h>
+
+#include "sdlpp/geometry.h"
+
+namespace SDL
+{
+class Renderer;
+
+/* A texture the renderer can draw into, for content that changes rarely:
+ * draw it once inside a TargetScope, then composite it every frame with
+ * Renderer::copySurface. Starts out fully transparent.
+ *
+ * Some backends (Direct3D) lose target contents when the device is reset;
+ * SDL then sends SDL_RENDER_TARGETS_RESET and the target must be redrawn. */
+class RenderTarget
+{
+	public:
+		RenderTarget(Renderer& renderer, Size size, SDL_BlendMode mode=SDL_BLENDMODE_BLEND);
+
+		RenderTarget(RenderTarget const&) = delete;
+		RenderTarget& operator=(RenderTarget const&) = delete;
+
+		RenderTarget(RenderTarget&& other) noexcept;
+		RenderTarget& operator=(RenderTarget&& other) noexcept;
+
+		~RenderTarget() noexcept;
+
+		Size getSize() const noexcept;
+		SDL_Texture* get() const noexcept;
+
+	private:
+		void release() noexcept;
+
+		SDL_Texture* texture;
+		std::weak_ptr<void const> alive;  // the renderer destroys the texture with itself
+		Size size;
+};
+
+/* Redirects drawing to a target for its lifetime and restores the previous
+ * target (scopes nest). Pending batched commands are flushed on both switches
+ * so they land on the target they were recorded for. Errors from the flush at
+ * the end of the scope cannot be reported; call Renderer::flush() first to see them. */
+class TargetScope
+{
+	public:
+		TargetScope(Renderer& renderer, RenderTarget& target);
+
+		TargetScope(TargetScope const&) = delete;
+		TargetScope& operator=(TargetScope const&) = delete;
+
+		~TargetScope() noexcept;
+
+	private:
+		Renderer& renderer;
+		SDL_Texture* previous;
+};
+}
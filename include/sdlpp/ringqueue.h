@@ -0,0 +1,182 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <optional>
+#include <utility>
+
+namespace SDL
+{
+/* Bounded lock-free multi-producer queue (Vyukov's sequence-numbered ring).
+ * Safe for any number of producers and consumers; EventQueue uses it with a
+ * single consumer. Sequence numbers live apart from the elements so that the
+ * element array stays densely packed. */
+template<typename T>
+class RingQueue
+{
+	public:
+		explicit RingQueue(std::size_t capacity)
+			: mask{std::bit_ceil(capacity < 2 ? std::size_t{2} : capacity) - 1}
+			, sequence{std::make_unique<std::atomic<std::size_t>[]>(mask + 1)}
+			, slots{std::allocator<T>{}.allocate(mask + 1)}
+		{
+			for (std::size_t i = 0; i <= mask; ++i)
+			{
+				sequence[i].store(i, std::memory_order_relaxed);
+			}
+		}
+
+		RingQueue(RingQueue const&) = delete;
+		RingQueue& operator=(RingQueue const&) = delete;
+
+		~RingQueue() noexcept
+		{
+			while (try_pop())
+			{}
+			std::allocator<T>{}.deallocate(slots, mask + 1);
+		}
+
+		template<typename U>
+		bool try_push(U&& value)
+		{
+			auto pos = reserve(1);
+			if (pos.second == 0)
+			{
+				return false;
+			}
+			publish(pos.first, std::forward<U>(value));
+			return true;
+		}
+
+		// pushes a prefix of [first, first+count) with a single reservation, returns its length
+		template<typename It>
+		std::size_t try_push_many(It first, std::size_t count)
+		{
+			auto [pos, reserved] = reserve(count);
+			for (std::size_t i = 0; i < reserved; ++i, ++first)
+			{
+				publish(pos + i, std::move(*first));
+			}
+			return reserved;
+		}
+
+		std::optional<T> try_pop()
+		{
+			auto [pos, claimed] = claim(1);
+			if (claimed == 0)
+			{
+				return std::nullopt;
+			}
+			return consume(pos);
+		}
+
+		// pops up to max elements into out with a single claim, returns how many
+		template<typename OutputIt>
+		std::size_t try_pop_many(OutputIt out, std::size_t max)
+		{
+			auto [pos, claimed] = claim(max);
+			for (std::size_t i = 0; i < claimed; ++i)
+			{
+				*out++ = consume(pos + i);
+			}
+			return claimed;
+		}
+
+		bool empty() const noexcept
+		{
+			auto pos = head.load(std::memory_order_acquire);
+			return sequence[pos & mask].load(std::memory_order_acquire) != pos + 1;
+		}
+
+		std::size_t capacity() const noexcept
+		{
+			return mask + 1;
+		}
+
+		/* Elements reserved and not yet claimed. Only an estimate under
+		 * concurrency: a slot stays occupied until its consumer has moved the
+		 * element out, after the claim, so capacity() - size() can exceed the
+		 * room a push will actually find. */
+		std::size_t size() const noexcept
+		{
+			auto h = head.load(std::memory_order_acquire);
+			auto t = tail.load(std::memory_order_acquire);
+			return std::min(t - h, mask + 1);
+		}
+
+	private:
+		using Diff = std::make_signed_t<std::size_t>;
+
+		std::pair<std::size_t, std::size_t> reserve(std::size_t count) noexcept
+		{
+			return acquireRange(tail, 0, count);
+		}
+
+		std::pair<std::size_t, std::size_t> claim(std::size_t count) noexcept
+		{
+			return acquireRange(head, 1, count);
+		}
+
+		/* A slot at position pos is free for producers when its sequence is pos
+		 * and ready for consumers when it is pos+1. Take as many consecutive
+		 * ready slots as possible (up to count) by advancing the cursor once. */
+		std::pair<std::size_t, std::size_t> acquireRange(std::atomic<std::size_t>& cursor, std::size_t ready, std::size_t count) noexcept
+		{
+			auto pos = cursor.load(std::memory_order_relaxed);
+			while (count > 0)
+			{
+				std::size_t n = 0;
+				while (n < count and n <= mask
+					and sequence[(pos + n) & mask].load(std::memory_order_acquire) == pos + n + ready)
+				{
+					++n;
+				}
+
+				if (n == 0)
+				{
+					auto seq = sequence[pos & mask].load(std::memory_order_acquire);
+					if (static_cast<Diff>(seq - (pos + ready)) < 0)
+					{
+						break;  // full (producers) or empty (consumers)
+					}
+					pos = cursor.load(std::memory_order_relaxed);
+					continue;
+				}
+
+				if (cursor.compare_exchange_weak(pos, pos + n, std::memory_order_relaxed))
+				{
+					return {pos, n};
+				}
+			}
+			return {pos, 0};
+		}
+
+		template<typename U>
+		void publish(std::size_t pos, U&& value)
+		{
+			::new (static_cast<void*>(slots + (pos & mask))) T(std::forward<U>(value));
+			sequence[pos & mask].store(pos + 1, std::memory_order_release);
+		}
+
+		T consume(std::size_t pos)
+		{
+			auto slot = slots + (pos & mask);
+			T value{std::move(*slot)};
+			slot->~T();
+			sequence[pos & mask].store(pos + mask + 1, std::memory_order_release);
+			return value;
+		}
+
+		std::size_t const mask;
+		std::unique_ptr<std::atomic<std::size_t>[]> sequence;
+		T* slots;
+
+		alignas(64) std::atomic<std::size_t> head{0};
+		alignas(64) std::atomic<std::size_t> tail{0};
+};
+}
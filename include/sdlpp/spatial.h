@@ -0,0 +1,137 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "sdlpp/geometry.h"
+
+namespace SDL
+{
+/* Rect storage shared by the spatial indexes: coordinates are kept as
+ * separate arrays so that the candidate tests in queries stream through
+ * memory. Ids are slots and are reused after removal. */
+class RectStore
+{
+	public:
+		using Id = std::uint32_t;
+
+		Id add(Rect r);
+		void remove(Id id) noexcept;
+		bool exists(Id id) const noexcept;  // added and not removed since
+		void set(Id id, Rect r) noexcept;
+		Rect get(Id id) const noexcept;
+
+		bool contains(Id id, Point p) const noexcept;
+		bool intersects(Id id, Rect r) const noexcept;
+
+		std::size_t size() const noexcept;  // live rects
+
+		/* Returns true the first time an id is seen in the current query, used
+		 * to report rects stored in several cells once. */
+		void beginQuery() const noexcept;
+		bool firstVisit(Id id) const noexcept;
+
+	private:
+		std::vector<int> x;
+		std::vector<int> y;
+		std::vector<int> w;
+		std::vector<int> h;
+		std::vector<Id> freeIds;
+		std::vector<bool> live;
+
+		mutable std::vector<std::uint32_t> stamps;
+		mutable std::uint32_t stamp = 0;
+};
+
+/* Uniform grid over fixed bounds. A rect is listed in every cell it overlaps;
+ * rects outside the bounds go to the border cells. Best when rects are of
+ * similar size and no larger than a few cells.
+ *
+ * Queries append matching ids to out (in no particular order) and return how
+ * many were added. Queries are not thread-safe, not even against each other.
+ * Removing an id that is not live does nothing. */
+class SpatialGrid
+{
+	public:
+		using Id = RectStore::Id;
+
+		SpatialGrid(Rect bounds, Size cellSize);
+
+		Id insert(Rect r);
+		void remove(Id id);
+		void move(Id id, Rect r);
+		Rect get(Id id) const noexcept;
+		std::size_t size() const noexcept;
+
+		std::size_t query(Point p, std::vector<Id>& out) const;
+		std::size_t query(Rect r, std::vector<Id>& out) const;
+
+	private:
+		struct CellRange
+		{
+			int x0, y0, x1, y1;  // inclusive
+		};
+
+		CellRange cellsOf(Rect r) const noexcept;
+		std::vector<Id>& cell(int cx, int cy) noexcept;
+		std::vector<Id> const& cell(int cx, int cy) const noexcept;
+		void link(Id id, Rect r);
+		void unlink(Id id, Rect r) noexcept;
+
+		Rect bounds;
+		Size cellSize;
+		Size cellCount;
+
+		std::vector<std::vector<Id>> cells;  // row-major
+		RectStore rects;
+};
+
+/* Loose quadtree over fixed bounds, stored as one dense grid of nodes per
+ * level instead of linked nodes. A rect lives in exactly one node: on the
+ * deepest level whose cells are at least as large as the rect, in the cell
+ * holding its centre. Nodes are loose (their reach extends half a cell on each
+ * side), so that cell always contains the rect. Suited to rects of widely
+ * varying size; moves that stay in the same node only update coordinates.
+ *
+ * The grid of a level is only allocated once a rect is stored on it, and
+ * maxDepth is at most 10: about a million nodes on the deepest level.
+ *
+ * Queries and removal behave as for SpatialGrid. */
+class LooseQuadtree
+{
+	public:
+		using Id = RectStore::Id;
+
+		LooseQuadtree(Rect bounds, int maxDepth=8);
+
+		Id insert(Rect r);
+		void remove(Id id);
+		void move(Id id, Rect r);
+		Rect get(Id id) const noexcept;
+		std::size_t size() const noexcept;
+
+		std::size_t query(Point p, std::vector<Id>& out) const;
+		std::size_t query(Rect r, std::vector<Id>& out) const;
+
+	private:
+		struct Location
+		{
+			int level;
+			std::size_t node;
+		};
+
+		Location locate(Rect r) const noexcept;
+		std::vector<Id>& items(Location l);
+		template<typename Test>
+		std::size_t collect(Rect area, std::vector<Id>& out, Test test) const;
+
+		Rect bounds;
+		int maxDepth;
+
+		std::vector<std::vector<std::vector<Id>>> levels;  // [level][row-major node], empty until used
+		std::vector<std::size_t> levelCounts;  // rects per level, to skip empty levels
+		std::vector<Location> locations;  // by id
+		RectStore rects;
+};
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#include <SDL2/SDL.h>
+
+#include "sdlpp/geometry.h"
+#include "sdlpp/pixel.h"
+
+namespace SDL
+{
+class Renderer;
+
+class RenderTarget;
+
+class Surface;
+
+struct AtlasHandle;
+
+struct Sprite
+{
+	SDL_FPoint position{0, 0};  // where the pivot ends up
+	SDL_FPoint scale{1, 1};
+	float rotation = 0;  // degrees clockwise around the pivot, like SDL_RenderCopyEx
+	SDL_FPoint pivot{0.5f, 0.5f};  // as a fraction of the source size
+	Color tint = Color::White;
+};
+
+/* Collects textured quads into one vertex and index array per texture and
+ * submits each run with a single SDL_RenderGeometry call. A run ends when the
+ * texture changes, the batch is full, or on flush(). Buffers are kept between
+ * frames, so a steady frame allocates nothing.
+ *
+ * flush() first flushes the renderer's own batch, so everything drawn through
+ * the renderer before the sprites ends up below them. */
+class SpriteBatch
+{
+	public:
+		explicit SpriteBatch(Renderer& renderer);
+
+		SpriteBatch(SpriteBatch const&) = delete;
+		SpriteBatch& operator=(SpriteBatch const&) = delete;
+
+		void draw(Surface const& s, Sprite const& sprite);
+		void draw(AtlasHandle h, Sprite const& sprite);
+		void draw(RenderTarget const& t, Sprite const& sprite);
+		void draw(SDL_Texture* texture, Rect src, Sprite const& sprite);
+
+		// per-corner colors instead of the sprite tint: top left, top right, bottom right, bottom left
+		void draw(SDL_Texture* texture, Rect src, Sprite const& sprite, std::array<Color, 4> const& corners);
+
+		void flush();
+		std::size_t pending() const noexcept;  // quads not submitted yet
+
+	private:
+		static constexpr std::size_t maxQuads = 16384;
+
+		void submit();
+		void setTexture(SDL_Texture* texture);
+		void push(Rect src, Sprite const& sprite, std::array<SDL_Color, 4> const& colors);
+
+		Renderer& renderer;
+
+		SDL_Texture* texture = nullptr;
+		float invWidth = 0;  // of the current texture, for texture coordinates
+		float invHeight = 0;
+
+		std::vector<SDL_Vertex> vertices;
+		std::vector<int> indices;  // the fixed quad pattern, only ever grown
+};
+}
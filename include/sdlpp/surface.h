@@ -1,8 +1,14 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <mutex>
 #include <filesystem>
+#include <iterator>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <vector>
 
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_image.h>
@@ -11,16 +17,122 @@
 
 namespace SDL
 {
+class Archive;
+
 class Renderer;
 
+class SurfacePool;
+
 struct Color;
 
+class Surface;
+
+// a band of rows of a PixelView, iterable as spans of pixels
+class PixelRows
+{
+	public:
+		class iterator
+		{
+			public:
+				using value_type = std::span<std::uint32_t>;
+				using difference_type = std::ptrdiff_t;
+
+				iterator() = default;
+				iterator(std::uint8_t* row_, int pitch_, int width_) noexcept
+					: row{row_}, pitch{pitch_}, width{width_}
+				{}
+
+				value_type operator*() const noexcept
+				{
+					return {reinterpret_cast<std::uint32_t*>(row), static_cast<std::size_t>(width)};
+				}
+
+				iterator& operator++() noexcept
+				{
+					row += pitch;
+					return *this;
+				}
+
+				iterator operator++(int) noexcept
+				{
+					auto t = *this;
+					++*this;
+					return t;
+				}
+
+				bool operator==(iterator const& other) const noexcept
+				{
+					return row == other.row;
+				}
+
+			private:
+				std::uint8_t* row = nullptr;
+				int pitch = 0;
+				int width = 0;
+		};
+
+		PixelRows(std::uint8_t* first_, int pitch_, int width_, int count_) noexcept
+			: first{first_}, pitch{pitch_}, width{width_}, count{count_}
+		{}
+
+		iterator begin() const noexcept
+		{
+			return {first, pitch, width};
+		}
+
+		iterator end() const noexcept
+		{
+			return {first + count * pitch, pitch, width};
+		}
+
+	private:
+		std::uint8_t* first;
+		int pitch;
+		int width;
+		int count;
+};
+
+/* Scoped direct access to the pixels of a 32-bit surface. The surface is
+ * locked (if SDL requires it) for the lifetime of the view, and its texture is
+ * invalidated once when the view is released rather than on every write.
+ * Disjoint row bands may be written from different threads. */
+class PixelView
+{
+	public:
+		PixelView(PixelView const&) = delete;
+		PixelView& operator=(PixelView const&) = delete;
+
+		PixelView(PixelView&& other) noexcept;
+		PixelView& operator=(PixelView&&) = delete;
+
+		~PixelView() noexcept;
+
+		Size getSize() const noexcept;
+
+		std::span<std::uint32_t> row(int y) const noexcept;
+		std::uint32_t& operator[](Point p) const noexcept;
+		PixelRows rows(int begin, int end) const noexcept;
+		PixelRows rows() const noexcept;
+
+		std::uint32_t map(Color c) const noexcept;
+		Color unmap(std::uint32_t pixel) const noexcept;
+
+	private:
+		friend class Surface;
+		explicit PixelView(Surface& s);
+
+		Surface* owner;
+		SDL_Surface* surface;
+};
+
 class Surface
 {
 	public:
 		Surface(Size size);
 		Surface(SDL_Surface* s) noexcept;
 		Surface(std::filesystem::path const& fname);
+		// raw entries are decoded straight from the mapping, pixel entries are copied
+		Surface(Archive const& archive, std::string_view name);
 
 		Surface(Surface const&) = delete;
 		Surface& operator=(Surface const&) = delete;
@@ -32,17 +144,54 @@ class Surface
 
 		Size getSize() const noexcept;
 		SDL_Texture* getTexture(Renderer const&) const;
+		SDL_Surface* get() const noexcept;
+
+		// 32-bit surfaces only, throws Error otherwise
+		PixelView lockPixels();
 
 		void putPixel(Point, Color) noexcept;
 		void fillRect(Rect, Color);
 		void blit(Surface const& other, Point p, Alignment align=Alignment::TopLeft);
+
+		/* CPU compositing through the PixelOps kernels. These require both
+		 * surfaces to be 32-bit with alpha in the top byte (as created by
+		 * Surface(Size)) and throw Error otherwise. */
+		void blendRect(Rect, Color);
+		void blitPremultiplied(Surface const& other, Point p, Alignment align=Alignment::TopLeft);
+		void blitColorKey(Surface const& other, Color key, Point p, Alignment align=Alignment::TopLeft);
 	
 	private:
+		friend class PixelView;
+		friend class SurfacePool;
+
+		/* One texture per renderer the surface has been drawn with. dirty holds
+		 * the regions changed since that texture was last updated: streaming
+		 * textures only re-upload these, other textures are recreated. It has
+		 * room for maxDirtyRects whenever there is a texture. */
+		struct CachedTexture
+		{
+			Renderer const* renderer = nullptr;
+			std::weak_ptr<void const> alive;  // expires with the renderer (and its textures)
+			SDL_Texture* texture = nullptr;
+			bool streaming = false;
+			std::vector<SDL_Rect> dirty;
+		};
+		static constexpr std::size_t maxDirtyRects = 8;
+
 		void release() noexcept;
 		void invalidateTexture() noexcept;
+		void markDirty(SDL_Rect r) noexcept;
+		static void addDirty(std::vector<SDL_Rect>& dirty, CachedTexture const& cached, SDL_Rect r) noexcept;
+
+		CachedTexture& findTexture(Renderer const&) const;
+		void createTexture(CachedTexture& cached, Renderer const&) const;
+		void uploadDirty(CachedTexture& cached) const;
+		static void destroyTexture(CachedTexture& cached) noexcept;
 
 		SDL_Surface* surface = nullptr;
-		mutable SDL_Texture* texture = nullptr;
+		SurfacePool* pool = nullptr;  // set when the pixels belong to a pool
+		mutable CachedTexture primary;  // the first renderer, kept inline for the common case
+		mutable std::vector<CachedTexture> others;
 
 		mutable std::mutex mutex;
 };
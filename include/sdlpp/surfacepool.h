@@ -0,0 +1,87 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+#include "sdlpp/geometry.h"
+#include "sdlpp/surface.h"
+
+namespace SDL
+{
+/* Recycles the pixel buffers of 32-bit surfaces (the layout of Surface(Size)).
+ *
+ * Buffers are grouped in power-of-two byte size classes, so a surface of any
+ * size can reuse a buffer freed by one of a similar size. Destroying an
+ * acquired Surface hands its buffer back instead of freeing it; buffers
+ * beyond the idle budget are freed. The pool must outlive its surfaces.
+ * Thread-safe, surfaces may be released from any thread. */
+class SurfacePool
+{
+	public:
+		struct Stats
+		{
+			std::uint64_t allocations = 0;  // buffers that had to be allocated
+			std::uint64_t reuses = 0;
+			std::uint64_t releases = 0;  // buffers handed back
+			std::uint64_t frees = 0;  // buffers dropped over budget or by trim
+			std::size_t idleBytes = 0;
+			std::size_t liveBytes = 0;
+		};
+
+		explicit SurfacePool(std::size_t idleBudget=64 << 20);
+
+		SurfacePool(SurfacePool const&) = delete;
+		SurfacePool& operator=(SurfacePool const&) = delete;
+
+		~SurfacePool() noexcept;
+
+		// cleared to transparent, like Surface(Size)
+		Surface acquire(Size size);
+
+		// frees every idle buffer
+		void trim() noexcept;
+
+		Stats getStats() const noexcept;
+		void resetCounters() noexcept;
+
+	private:
+		friend class Surface;
+
+		static constexpr std::size_t minClass = 12;  // 4 KiB
+		static constexpr std::size_t classCount = 20;  // up to 2 GiB
+		static std::size_t sizeClass(std::size_t bytes) noexcept;
+
+		void recycle(void* pixels, std::size_t bytes) noexcept;
+
+		std::size_t idleBudget;
+
+		mutable std::mutex mutex;
+		std::array<std::vector<void*>, classCount> idle;
+		Stats stats;
+};
+
+/* Scratch surfaces for one frame, all released together by reset(). The
+ * buffers come from a pool, so a steady frame allocates nothing. */
+class SurfaceArena
+{
+	public:
+		explicit SurfaceArena(SurfacePool& pool);
+
+		SurfaceArena(SurfaceArena const&) = delete;
+		SurfaceArena& operator=(SurfaceArena const&) = delete;
+
+		// valid until the next reset
+		Surface& make(Size size);
+
+		void reset() noexcept;
+		std::size_t size() const noexcept;
+
+	private:
+		SurfacePool& pool;
+		std::deque<Surface> surfaces;
+};
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "sdlpp/pixel.h"
+#include "sdlpp/surface.h"
+
+namespace SDL
+{
+class Font;
+
+class Renderer;
+
+/* Memoizes rendered text surfaces, together with their textures, for one font
+ * and renderer. Entries are evicted least recently used first once the cached
+ * pixels exceed the byte budget; the most recent entry is always kept.
+ * Returned references are valid until the next render or clear call. */
+class TextCache
+{
+	public:
+		struct Stats
+		{
+			std::uint64_t hits = 0;
+			std::uint64_t misses = 0;
+			std::uint64_t evictions = 0;
+			std::size_t bytes = 0;
+			std::size_t entries = 0;
+		};
+
+		TextCache(Font const& font, Renderer& renderer, std::size_t budget);
+
+		TextCache(TextCache const&) = delete;
+		TextCache& operator=(TextCache const&) = delete;
+
+		Surface const& render(std::string_view text, int ptsize, Color color);
+		Surface const& renderWrapped(std::string_view text, int ptsize, unsigned int width, Color color);
+
+		void setBudget(std::size_t budget);
+		void clear() noexcept;
+
+		Stats getStats() const noexcept;
+		void resetCounters() noexcept;
+
+	private:
+		template<typename Text>
+		struct BasicKey
+		{
+			Text text;
+			int ptsize;
+			Color color;
+			std::optional<unsigned int> width;  // nullopt when not wrapped
+		};
+		using Key = BasicKey<std::string>;
+		using KeyView = BasicKey<std::string_view>;
+
+		struct KeyHash
+		{
+			using is_transparent = void;
+			std::size_t operator()(Key const& k) const noexcept;
+			std::size_t operator()(KeyView const& k) const noexcept;
+		};
+
+		struct KeyEqual
+		{
+			using is_transparent = void;
+			template<typename L, typename R>
+			bool operator()(L const& lhs, R const& rhs) const noexcept
+			{
+				return lhs.ptsize == rhs.ptsize && lhs.color == rhs.color
+					&& lhs.width == rhs.width && std::string_view{lhs.text} == std::string_view{rhs.text};
+			}
+		};
+
+		struct Entry
+		{
+			Surface surface;
+			std::size_t bytes;
+		};
+		using Lru = std::list<std::pair<Key, Entry>>;  // most recently used first
+
+		Surface const& get(KeyView key);
+		void evict();
+
+		Font const& font;
+		Renderer& renderer;
+		std::size_t budget;
+
+		Lru lru;
+		std::unordered_map<Key, Lru::iterator, KeyHash, KeyEqual> index;
+		Stats stats;
+};
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "sdlpp/geometry.h"
+#include "sdlpp/rendertarget.h"
+
+namespace SDL
+{
+class Renderer;
+
+class Surface;
+
+/* A grid of tiles from a tileset surface (tiles numbered row by row), drawn
+ * through per-chunk render targets: a chunk is rendered from its tiles when it
+ * first becomes visible or after one of its tiles changed, and is a single
+ * copy otherwise. Only chunks intersecting the viewport are touched, so draw
+ * calls scale with the visible chunks rather than tiles.
+ *
+ * The tileset must outlive the map. Chunk targets are kept once created;
+ * releaseHidden() drops those that were not visible in the last draw. */
+class TileMap
+{
+	public:
+		using Tile = std::uint16_t;
+		static constexpr Tile empty = 0xFFFF;
+
+		struct Stats
+		{
+			std::size_t visibleChunks = 0;  // in the last draw
+			std::size_t renderedChunks = 0;  // re-rendered in the last draw
+			std::size_t cachedChunks = 0;  // holding a render target
+		};
+
+		TileMap(Renderer& renderer, Surface const& tileset, Size tileSize, Size mapSize, int chunkTiles=16);
+
+		TileMap(TileMap const&) = delete;
+		TileMap& operator=(TileMap const&) = delete;
+
+		Size getSize() const noexcept;  // in tiles
+		Size getPixelSize() const noexcept;
+
+		Tile get(Point tile) const noexcept;  // empty outside the map
+		void set(Point tile, Tile t) noexcept;  // ignored outside the map
+		void fill(Rect tiles, Tile t) noexcept;
+
+		// forces every chunk to be re-rendered, e.g. after the tileset changed
+		void invalidate() noexcept;
+
+		/* Draws the part of the map under the viewport, camera being the map
+		 * pixel shown at the top-left corner of the viewport. */
+		void draw(Point camera);
+
+		void releaseHidden() noexcept;
+		Stats getStats() const noexcept;
+
+	private:
+		struct Chunk
+		{
+			std::optional<RenderTarget> target;
+			bool dirty = true;
+			bool visible = false;
+		};
+
+		Chunk& chunkAt(Point chunk) noexcept;
+		Rect chunkPixels(Point chunk) const noexcept;
+		void render(Point chunk, Chunk& c);
+
+		Renderer& renderer;
+		Surface const& tileset;
+		Size tileSize;
+		Size mapSize;
+		int chunkTiles;
+		Size chunkCount;
+		int tilesetColumns;
+
+		std::vector<Tile> tiles;  // row-major
+		std::vector<Chunk> chunks;  // row-major
+		Stats stats;
+};
+}
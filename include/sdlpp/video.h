@@ -1,19 +1,30 @@
 #pragma once
 
+#include <cstdint>
+#include <memory>
 #include <string>
+#include <string_view>
+#include <vector>
 
 #include <SDL2/SDL.h>
 
 #include "sdlpp/geometry.h"
+#include "sdlpp/pixel.h"
 
 namespace SDL
 {
 class Window;
 
-struct Color;
-
 class Surface;
 
+struct AtlasHandle;
+
+class GlyphAtlas;
+
+class RenderTarget;
+
+class TargetScope;
+
 class Renderer
 {
 	public:
@@ -21,23 +32,79 @@ class Renderer
 		~Renderer() noexcept;
 
 		void clear(Color);
-		void present() noexcept;
+		void present();
 
 		Rect getViewport() const noexcept;
 
 		void copySurface(Surface const& s, Point p, Alignment align=Alignment::TopLeft);
 		void copySurface(Surface const& s, Rect r, Point p, Alignment align=Alignment::TopLeft);
+		void copySurface(AtlasHandle h, Point p, Alignment align=Alignment::TopLeft);
+		void copySurface(RenderTarget const& t, Point p, Alignment align=Alignment::TopLeft);
+		void copySurface(RenderTarget const& t, Rect r, Point p, Alignment align=Alignment::TopLeft);
 		void drawLine(Point from, Point to, Color);
 		void drawRect(Rect, Color);
 		void fillRect(Rect, Color);
 		void putPixel(Point, Color);
+		void drawText(GlyphAtlas& glyphs, std::string_view text, int ptsize, Point p, Color);
+
+		void setBlendMode(SDL_BlendMode);
+
+		// draws into the target until the returned scope ends, see TargetScope
+		[[nodiscard]] TargetScope setTarget(RenderTarget& target);
+
+		/* While batching is enabled, draw calls are recorded instead of being
+		 * sent to SDL immediately. Recorded commands are sorted by texture,
+		 * blend mode and color and submitted as runs on flush() or present(),
+		 * in the order each state was first used since the last flush. Draw
+		 * order is only preserved between commands sharing the same state,
+		 * and copied surfaces must not be modified or destroyed before the flush. */
+		void setBatching(bool enabled);
+		bool isBatching() const noexcept;
+		void flush();
 
 		SDL_Renderer* get() const noexcept;
 
+		// expires when the renderer is destroyed, taking every texture it created with it
+		std::weak_ptr<void const> getLifetime() const noexcept;
+
 	private:
 		SDL_Renderer* renderer;
+		std::shared_ptr<void const> lifetime = std::make_shared<char>();
+		SDL_BlendMode blendMode = SDL_BLENDMODE_BLEND;
 
 		void setColor(Color);
+		void copyTexture(SDL_Texture*, SDL_Rect const& src, SDL_Rect const& dst, Color tint=Color::White);
+
+		enum class DrawKind: std::uint8_t
+		{
+			Point, Line, Rect, FillRect, Copy,
+		};
+
+		struct DrawCommand
+		{
+			SDL_Texture* texture;
+			SDL_BlendMode blendMode;
+			Color color;
+			DrawKind kind;
+			SDL_Rect a;  // point/line start+end/rect/copy source
+			SDL_Rect b;  // copy destination
+			std::uint32_t rank;  // recording position, then that of the first command with the same state
+		};
+
+		struct DrawBatch
+		{
+			bool enabled = false;
+			std::vector<DrawCommand> commands;
+
+			// scratch buffers reused between flushes
+			std::vector<SDL_Point> points;
+			std::vector<SDL_Rect> rects;
+			std::vector<SDL_Vertex> vertices;
+			std::vector<int> indices;
+		} batch;
+
+		void record(DrawKind, Color, SDL_Rect a, SDL_Rect b={}, SDL_Texture* texture=nullptr);
+		void submitRun(DrawCommand const* begin, DrawCommand const* end);
 };
 
 class Window
@@ -0,0 +1,385 @@
+#include "sdlpp/archive.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <SDL2/SDL.h>
+
+#include "sdlpp/error.h"
+#include "sdlpp/surface.h"
+
+namespace SDL
+{
+namespace
+{
+constexpr char magic[8] = {'S', 'D', 'L', 'P', 'P', 'A', 'K', '1'};
+constexpr std::uint32_t version = 1;
+constexpr std::size_t headerSize = 8 + 4 + 4 + 8;
+constexpr std::size_t dataAlignment = 16;
+
+// bounds-checked little-endian reader over the mapping
+class Reader
+{
+	public:
+		Reader(std::span<std::byte const> data_, std::size_t pos_)
+			: data{data_}
+			, pos{pos_}
+		{}
+
+		template<typename T>
+		T read()
+		{
+			auto bytes = take(sizeof(T));
+			T v = 0;
+			for (std::size_t i = 0; i < sizeof(T); ++i)
+			{
+				v |= static_cast<T>(std::to_integer<std::uint8_t>(bytes[i])) << (8 * i);
+			}
+			return v;
+		}
+
+		std::span<std::byte const> take(std::size_t n)
+		{
+			if (pos > data.size() or n > data.size() - pos)
+			{
+				throw Error{"Truncated archive"};
+			}
+			auto s = data.subspan(pos, n);
+			pos += n;
+			return s;
+		}
+
+	private:
+		std::span<std::byte const> data;
+		std::size_t pos;
+};
+
+template<typename T>
+void put(std::vector<std::byte>& out, T v)
+{
+	for (std::size_t i = 0; i < sizeof(T); ++i)
+	{
+		out.push_back(static_cast<std::byte>((v >> (8 * i)) & 0xff));
+	}
+}
+
+// maps the whole file read-only, the file itself need not stay open
+std::byte const* mapFile(std::filesystem::path const& fname, std::size_t& length)
+{
+#ifdef _WIN32
+	auto file = ::CreateFileW(fname.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		throw Error{"Failed to open archive " + fname.string()};
+	}
+
+	LARGE_INTEGER size;
+	if (not ::GetFileSizeEx(file, &size) or size.QuadPart < static_cast<LONGLONG>(headerSize))
+	{
+		::CloseHandle(file);
+		throw Error{"Not an archive: " + fname.string()};
+	}
+	length = static_cast<std::size_t>(size.QuadPart);
+
+	auto section = ::CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	::CloseHandle(file);  // the mapping object keeps the file alive
+	if (section == nullptr)
+	{
+		throw Error{"Failed to map archive " + fname.string()};
+	}
+	auto m = ::MapViewOfFile(section, FILE_MAP_READ, 0, 0, 0);
+	::CloseHandle(section);  // and the view keeps the mapping object alive
+	if (m == nullptr)
+	{
+		throw Error{"Failed to map archive " + fname.string()};
+	}
+	return static_cast<std::byte const*>(m);
+#else
+	auto fd = ::open(fname.c_str(), O_RDONLY);
+	if (fd < 0)
+	{
+		throw Error{"Failed to open archive " + fname.string()};
+	}
+
+	struct stat st;
+	if (::fstat(fd, &st) < 0 or st.st_size < static_cast<off_t>(headerSize))
+	{
+		::close(fd);
+		throw Error{"Not an archive: " + fname.string()};
+	}
+	length = static_cast<std::size_t>(st.st_size);
+
+	auto m = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd);  // the mapping keeps the file alive
+	if (m == MAP_FAILED)
+	{
+		throw Error{"Failed to map archive " + fname.string()};
+	}
+	return static_cast<std::byte const*>(m);
+#endif
+}
+
+void unmapFile(std::byte const* mapping, [[maybe_unused]] std::size_t length) noexcept
+{
+#ifdef _WIN32
+	::UnmapViewOfFile(mapping);
+#else
+	::munmap(const_cast<std::byte*>(mapping), length);
+#endif
+}
+}
+
+Archive::Archive(std::filesystem::path const& fname)
+{
+	mapping = mapFile(fname, length);
+
+	try
+	{
+		parse();
+	}
+	catch (...)
+	{
+		release();
+		throw;
+	}
+}
+
+Archive::Archive(Archive&& other) noexcept
+	: mapping{std::exchange(other.mapping, nullptr)}
+	, length{std::exchange(other.length, 0)}
+	, list{std::move(other.list)}
+	, index{std::move(other.index)}
+{}
+
+Archive& Archive::operator=(Archive&& other) noexcept
+{
+	if (this != &other)
+	{
+		release();
+		mapping = std::exchange(other.mapping, nullptr);
+		length = std::exchange(other.length, 0);
+		list = std::move(other.list);
+		index = std::move(other.index);
+	}
+	return *this;
+}
+
+Archive::~Archive() noexcept
+{
+	release();
+}
+
+void Archive::release() noexcept
+{
+	if (mapping != nullptr)
+	{
+		unmapFile(mapping, length);
+	}
+	mapping = nullptr;
+	length = 0;
+	list.clear();
+	index.clear();
+}
+
+void Archive::parse()
+{
+	std::span<std::byte const> all{mapping, length};
+	if (std::memcmp(mapping, magic, sizeof(magic)) != 0)
+	{
+		throw Error{"Not an archive"};
+	}
+
+	Reader header{all, sizeof(magic)};
+	if (header.read<std::uint32_t>() != version)
+	{
+		throw Error{"Unsupported archive version"};
+	}
+	auto count = header.read<std::uint32_t>();
+	auto indexOffset = header.read<std::uint64_t>();
+	if (indexOffset > length)
+	{
+		throw Error{"Truncated archive"};
+	}
+
+	Reader records{all, static_cast<std::size_t>(indexOffset)};
+	list.reserve(count);
+	index.reserve(count);
+	for (std::uint32_t i = 0; i < count; ++i)
+	{
+		auto offset = records.read<std::uint64_t>();
+		auto size = records.read<std::uint64_t>();
+		auto kind = records.read<std::uint32_t>();
+		auto format = records.read<std::uint32_t>();
+		auto width = records.read<std::uint32_t>();
+		auto height = records.read<std::uint32_t>();
+		auto pitch = records.read<std::uint32_t>();
+		auto nameLength = records.read<std::uint32_t>();
+		auto name = records.take(nameLength);
+
+		if (kind > static_cast<std::uint32_t>(Kind::Pixels))
+		{
+			throw Error{"Unknown archive entry kind"};
+		}
+		if (offset > length or size > length - offset)
+		{
+			throw Error{"Truncated archive"};
+		}
+		// rows are copied width * 4 bytes at a time, pitch apart
+		auto const intMax = std::uint32_t{INT_MAX};
+		if (kind == static_cast<std::uint32_t>(Kind::Pixels)
+			and (SDL_BYTESPERPIXEL(format) != 4
+				or width > intMax or height > intMax or pitch > intMax
+				or pitch < std::uint64_t{width} * 4
+				or std::uint64_t{pitch} * height > size))
+		{
+			throw Error{"Malformed pixel entry in archive"};
+		}
+
+		Entry e{
+			{reinterpret_cast<char const*>(name.data()), name.size()},
+			static_cast<Kind>(kind),
+			all.subspan(static_cast<std::size_t>(offset), static_cast<std::size_t>(size)),
+			format,
+			static_cast<int>(width),
+			static_cast<int>(height),
+			static_cast<int>(pitch),
+		};
+		if (not index.emplace(e.name, list.size()).second)
+		{
+			throw Error{"Duplicate archive entry " + std::string{e.name}};
+		}
+		list.push_back(e);
+	}
+}
+
+Archive::Entry const* Archive::find(std::string_view name) const noexcept
+{
+	auto it = index.find(name);
+	return it == index.end() ? nullptr : &list[it->second];
+}
+
+Archive::Entry const& Archive::at(std::string_view name) const
+{
+	auto e = find(name);
+	if (e == nullptr)
+	{
+		throw Error{"No archive entry " + std::string{name}};
+	}
+	return *e;
+}
+
+std::span<Archive::Entry const> Archive::entries() const noexcept
+{
+	return list;
+}
+
+void ArchiveWriter::add(std::string name, std::span<std::byte const> data)
+{
+	pending.push_back({std::move(name), Archive::Kind::Raw, {data.begin(), data.end()}});
+}
+
+void ArchiveWriter::addFile(std::string name, std::filesystem::path const& fname)
+{
+	std::ifstream in{fname, std::ios::binary};
+	if (not in)
+	{
+		throw Error{"Failed to open " + fname.string()};
+	}
+	std::vector<char> contents{std::istreambuf_iterator<char>{in}, {}};
+	add(std::move(name), std::as_bytes(std::span{contents}));
+}
+
+void ArchiveWriter::addPixels(std::string name, Surface const& surface)
+{
+	auto s = surface.get();
+	SDL_Surface* converted = nullptr;
+	if (s->format->BytesPerPixel != 4)
+	{
+		converted = SDL_ConvertSurfaceFormat(s, SDL_PIXELFORMAT_ARGB8888, 0);
+		if (converted == nullptr)
+		{
+			throw Error{SDL_GetError()};
+		}
+		s = converted;
+	}
+
+	// stored tightly packed, whatever the pitch of the source
+	Pending p{std::move(name), Archive::Kind::Pixels, {}, s->format->format,
+		static_cast<std::uint32_t>(s->w), static_cast<std::uint32_t>(s->h), static_cast<std::uint32_t>(s->w * 4)};
+	p.data.resize(std::size_t{p.pitch} * p.height);
+
+	SDL_LockSurface(s);
+	auto pixels = static_cast<std::byte const*>(s->pixels);
+	for (int y = 0; y < s->h; ++y)
+	{
+		std::memcpy(p.data.data() + std::size_t{p.pitch} * y, pixels + y * s->pitch, p.pitch);
+	}
+	SDL_UnlockSurface(s);
+	SDL_FreeSurface(converted);
+
+	pending.push_back(std::move(p));
+}
+
+void ArchiveWriter::write(std::filesystem::path const& fname) const
+{
+	std::vector<std::byte> out;
+	out.insert(out.end(), reinterpret_cast<std::byte const*>(magic), reinterpret_cast<std::byte const*>(magic) + sizeof(magic));
+	put(out, version);
+	put(out, static_cast<std::uint32_t>(pending.size()));
+	put(out, std::uint64_t{0});  // index offset, patched below
+
+	std::vector<std::uint64_t> offsets;
+	for (auto const& p: pending)
+	{
+		out.resize((out.size() + dataAlignment - 1) / dataAlignment * dataAlignment);
+		offsets.push_back(out.size());
+		out.insert(out.end(), p.data.begin(), p.data.end());
+	}
+
+	auto indexOffset = static_cast<std::uint64_t>(out.size());
+	for (std::size_t i = 0; i < pending.size(); ++i)
+	{
+		auto const& p = pending[i];
+		put(out, offsets[i]);
+		put(out, static_cast<std::uint64_t>(p.data.size()));
+		put(out, static_cast<std::uint32_t>(p.kind));
+		put(out, p.format);
+		put(out, p.width);
+		put(out, p.height);
+		put(out, p.pitch);
+		put(out, static_cast<std::uint32_t>(p.name.size()));
+		auto name = std::as_bytes(std::span{p.name});
+		out.insert(out.end(), name.begin(), name.end());
+	}
+
+	std::vector<std::byte> patch;
+	put(patch, indexOffset);
+	std::copy(patch.begin(), patch.end(), out.begin() + headerSize - 8);
+
+	std::ofstream file{fname, std::ios::binary | std::ios::trunc};
+	file.write(reinterpret_cast<char const*>(out.data()), static_cast<std::streamsize>(out.size()));
+	if (not file)
+	{
+		throw Error{"Failed to write archive " + fname.string()};
+	}
+}
+}
@@ -0,0 +1,171 @@
+#include "sdlpp/assetloader.h"
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+
+#include <SDL2/SDL.h>
+
+#include "sdlpp/error.h"
+#include "sdlpp/video.h"
+
+namespace SDL
+{
+namespace
+{
+/* SDL_ttf creates every face from one shared FreeType library, which must not
+ * be used by two threads at once. This only keeps the workers from opening
+ * fonts concurrently; faces created or closed on other threads are not
+ * covered, see AssetLoader. */
+std::mutex fontMutex;
+}
+
+AssetLoader::AssetLoader(Renderer& renderer_, unsigned int threads)
+	: renderer{renderer_}
+{
+	threads = std::max(threads, 1u);
+	workers.reserve(threads);
+	for (unsigned int i = 0; i < threads; ++i)
+	{
+		workers.emplace_back([this](std::stop_token stop)
+		{
+			work(stop);
+		});
+	}
+}
+
+AssetLoader::~AssetLoader() noexcept
+{
+	for (auto& w: workers)
+	{
+		w.request_stop();
+	}
+	workers.clear();
+}
+
+std::future<Surface> AssetLoader::loadSurface(std::filesystem::path fname)
+{
+	auto promise = std::make_shared<std::promise<Surface>>();
+	auto result = promise->get_future();
+
+	enqueue([this, promise, fname = std::move(fname)]
+	{
+		try
+		{
+			Surface s{fname};
+
+			// do any format conversion here rather than on the render thread,
+			// 32-bit surfaces are uploaded as they are
+			auto raw = s.get();
+			if (raw->format->BytesPerPixel != 4 and not SDL_HasColorKey(raw))
+			{
+				auto converted = SDL_ConvertSurfaceFormat(raw, SDL_PIXELFORMAT_ARGB8888, 0);
+				if (converted == nullptr)
+				{
+					throw Error{SDL_GetError()};
+				}
+				s = Surface{converted};
+			}
+
+			std::unique_lock hold{uploadMutex};
+			// the job keeps its promise if this throws, for the catch below
+			uploads.push_back({std::move(s), promise});
+		}
+		catch (...)
+		{
+			promise->set_exception(std::current_exception());
+		}
+	});
+	return result;
+}
+
+std::future<Font> AssetLoader::loadFont(std::string fname, int ptsize)
+{
+	auto promise = std::make_shared<std::promise<Font>>();
+	auto result = promise->get_future();
+
+	enqueue([promise, fname = std::move(fname), ptsize]
+	{
+		try
+		{
+			std::unique_lock hold{fontMutex};
+			promise->set_value(Font{fname, ptsize});
+		}
+		catch (...)
+		{
+			promise->set_exception(std::current_exception());
+		}
+	});
+	return result;
+}
+
+std::size_t AssetLoader::drainUploads(std::chrono::microseconds budget)
+{
+	auto const start = std::chrono::steady_clock::now();
+	std::size_t count = 0;
+
+	do
+	{
+		std::unique_lock hold{uploadMutex};
+		if (uploads.empty())
+		{
+			break;
+		}
+		auto upload = std::move(uploads.front());
+		uploads.pop_front();
+		hold.unlock();
+
+		try
+		{
+			upload.surface.getTexture(renderer);
+			upload.promise->set_value(std::move(upload.surface));
+		}
+		catch (...)
+		{
+			upload.promise->set_exception(std::current_exception());
+		}
+		++count;
+	}
+	while (std::chrono::steady_clock::now() - start < budget);
+
+	return count;
+}
+
+std::size_t AssetLoader::pendingLoads() const
+{
+	std::unique_lock hold{jobMutex};
+	return jobs.size() + running;
+}
+
+std::size_t AssetLoader::pendingUploads() const
+{
+	std::unique_lock hold{uploadMutex};
+	return uploads.size();
+}
+
+void AssetLoader::enqueue(std::function<void()> job)
+{
+	{
+		std::unique_lock hold{jobMutex};
+		jobs.push_back(std::move(job));
+	}
+	jobReady.notify_one();
+}
+
+void AssetLoader::work(std::stop_token stop)
+{
+	std::unique_lock hold{jobMutex};
+	while (jobReady.wait(hold, stop, [this] { return not jobs.empty(); }))
+	{
+		auto job = std::move(jobs.front());
+		jobs.pop_front();
+		++running;
+
+		hold.unlock();
+		job();
+		hold.lock();
+
+		--running;
+	}
+}
+}
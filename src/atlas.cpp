@@ -0,0 +1,334 @@
+#include "sdlpp/atlas.h"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+#include "sdlpp/error.h"
+#include "sdlpp/profiler.h"
+#include "sdlpp/video.h"
+
+namespace SDL
+{
+namespace
+{
+void copyPixels(SDL_Surface* src, SDL_Rect const* srcRect, SDL_Surface* dst, Point p)
+{
+	// atlas pages must receive the exact source pixels, not a blend over transparency
+	SDL_BlendMode mode;
+	SDL_GetSurfaceBlendMode(src, &mode);
+	SDL_SetSurfaceBlendMode(src, SDL_BLENDMODE_NONE);
+
+	SDL_Rect dstRect{p.x, p.y, 0, 0};
+	auto result = SDL_BlitSurface(src, srcRect, dst, &dstRect);
+	SDL_SetSurfaceBlendMode(src, mode);
+	if (result < 0)
+	{
+		throw Error{SDL_GetError()};
+	}
+}
+}
+
+Atlas::Atlas(Renderer& renderer_, Size pageSize_, int padding_)
+	: renderer{renderer_}
+	, alive{renderer_.getLifetime()}
+	, pageSize{pageSize_}
+	, padding{padding_}
+{}
+
+Atlas::~Atlas() noexcept
+{
+	destroyTextures(pages);
+}
+
+AtlasHandle Atlas::insert(Surface const& s)
+{
+	auto size = s.getSize();
+	if (size.w + padding > pageSize.w or size.h + padding > pageSize.h)
+	{
+		throw Error{"Surface does not fit into an atlas page"};
+	}
+
+	Point where;
+	auto pageIndex = place(pages, size, where);
+	auto& page = pages[pageIndex];
+	copyPixels(s.get(), nullptr, page.pixels.get(), where);
+	upload(page, {where, size});
+
+	std::uint32_t id;
+	if (freeIds.empty())
+	{
+		id = static_cast<std::uint32_t>(entries.size());
+		entries.push_back({pageIndex, {where, size}, true, 0});
+	}
+	else
+	{
+		id = freeIds.back();
+		freeIds.pop_back();
+		entries[id] = {pageIndex, {where, size}, true, entries[id].generation};
+	}
+
+	return {this, id, entries[id].generation};
+}
+
+void Atlas::erase(AtlasHandle h) noexcept
+{
+	if (not contains(h))
+	{
+		return;
+	}
+	auto& entry = entries[h.id];
+	entry.alive = false;
+	++entry.generation;
+	freeIds.push_back(h.id);
+
+	auto& page = pages[entry.page];
+	page.usedArea -= entry.rect.s.w * entry.rect.s.h;
+	if (--page.entries == 0)
+	{
+		// an empty page can be reused from scratch without a full repack
+		resetSkyline(page);
+	}
+}
+
+void Atlas::repack()
+{
+	std::vector<std::uint32_t> live;
+	for (std::uint32_t id = 0; id < entries.size(); ++id)
+	{
+		if (entries[id].alive)
+		{
+			live.push_back(id);
+		}
+	}
+
+	// tallest first packs best with a skyline
+	std::sort(live.begin(), live.end(), [this](auto lhs, auto rhs)
+	{
+		auto const& l = entries[lhs].rect.s;
+		auto const& r = entries[rhs].rect.s;
+		return std::pair{l.h, l.w} > std::pair{r.h, r.w};
+	});
+
+	std::vector<Page> packed;
+	std::vector<Entry> moved = entries;
+	for (auto id: live)
+	{
+		auto const& old = entries[id];
+		Point where;
+		auto pageIndex = place(packed, old.rect.s, where);
+		SDL_Rect src = old.rect;
+		copyPixels(pages[old.page].pixels.get(), &src, packed[pageIndex].pixels.get(), where);
+		moved[id] = {pageIndex, {where, old.rect.s}, true, old.generation};
+	}
+
+	for (auto& page: packed)
+	{
+		upload(page, {{0, 0}, pageSize});
+	}
+	destroyTextures(pages);
+
+	pages = std::move(packed);
+	entries = std::move(moved);
+}
+
+bool Atlas::contains(AtlasHandle h) const noexcept
+{
+	return h.atlas == this and h.id < entries.size()
+		and entries[h.id].alive and entries[h.id].generation == h.generation;
+}
+
+SDL_Texture* Atlas::getTexture(AtlasHandle h) const noexcept
+{
+	return contains(h) ? pages[entries[h.id].page].texture : nullptr;
+}
+
+Rect Atlas::getRect(AtlasHandle h) const noexcept
+{
+	return contains(h) ? entries[h.id].rect : Rect{{0, 0}, {0, 0}};
+}
+
+std::size_t Atlas::pageCount() const noexcept
+{
+	return pages.size();
+}
+
+double Atlas::occupancy() const noexcept
+{
+	if (pages.empty())
+	{
+		return 0.0;
+	}
+	auto used = std::accumulate(pages.begin(), pages.end(), 0L, [](long acc, auto const& page)
+	{
+		return acc + page.usedArea;
+	});
+	return static_cast<double>(used) / (static_cast<double>(pageSize.w) * pageSize.h * pages.size());
+}
+
+Atlas::Page& Atlas::addPage(std::vector<Page>& into)
+{
+	auto& page = into.emplace_back(Page{Surface{pageSize}, nullptr, {}, 0, 0});
+	page.texture = SDL_CreateTexture(
+		renderer.get(), page.pixels.get()->format->format,
+		SDL_TEXTUREACCESS_STATIC, pageSize.w, pageSize.h
+	);
+	if (page.texture == nullptr)
+	{
+		throw Error{SDL_GetError()};
+	}
+	SDLPP_PROFILE_COUNT(TextureCreations, 1);
+	if (SDL_SetTextureBlendMode(page.texture, SDL_BLENDMODE_BLEND) < 0)
+	{
+		throw Error{SDL_GetError()};
+	}
+	resetSkyline(page);
+	return page;
+}
+
+void Atlas::resetSkyline(Page& page) const
+{
+	page.skyline.assign({{0, 0, pageSize.w}});
+	page.usedArea = 0;
+	page.entries = 0;
+	SDL_FillRect(page.pixels.get(), nullptr, 0);
+	if (page.texture != nullptr)
+	{
+		SDL_UpdateTexture(page.texture, nullptr, page.pixels.get()->pixels, page.pixels.get()->pitch);
+	}
+}
+
+std::uint32_t Atlas::place(std::vector<Page>& into, Size s, Point& where)
+{
+	for (std::uint32_t i = 0; i < into.size(); ++i)
+	{
+		if (auto p = allocate(into[i], s))
+		{
+			where = *p;
+			return i;
+		}
+	}
+
+	auto& page = addPage(into);
+	where = *allocate(page, s);  // always fits into an empty page, checked on insert
+	return static_cast<std::uint32_t>(into.size() - 1);
+}
+
+int Atlas::fit(Page const& page, std::size_t index, Size s) const noexcept
+{
+	auto const& skyline = page.skyline;
+	if (skyline[index].x + s.w > pageSize.w)
+	{
+		return -1;
+	}
+
+	auto y = skyline[index].y;
+	auto widthLeft = s.w;
+	for (auto i = index; widthLeft > 0; ++i)
+	{
+		y = std::max(y, skyline[i].y);
+		if (y + s.h > pageSize.h)
+		{
+			return -1;
+		}
+		widthLeft -= skyline[i].w;
+	}
+	return y;
+}
+
+std::optional<Point> Atlas::allocate(Page& page, Size s) const
+{
+	Size padded{s.w + padding, s.h + padding};
+	auto& skyline = page.skyline;
+
+	auto bestIndex = skyline.size();
+	auto bestBottom = std::numeric_limits<int>::max();
+	auto bestWidth = std::numeric_limits<int>::max();
+	for (std::size_t i = 0; i < skyline.size(); ++i)
+	{
+		auto y = fit(page, i, padded);
+		if (y < 0)
+		{
+			continue;
+		}
+		auto bottom = y + padded.h;
+		if (bottom < bestBottom or (bottom == bestBottom and skyline[i].w < bestWidth))
+		{
+			bestIndex = i;
+			bestBottom = bottom;
+			bestWidth = skyline[i].w;
+		}
+	}
+
+	if (bestIndex == skyline.size())
+	{
+		return std::nullopt;
+	}
+
+	Point p{skyline[bestIndex].x, bestBottom - padded.h};
+	skyline.insert(skyline.begin() + bestIndex, {p.x, bestBottom, padded.w});
+
+	// trim or drop the nodes now shadowed by the new one
+	for (auto i = bestIndex + 1; i < skyline.size();)
+	{
+		auto const& prev = skyline[i - 1];
+		auto prevEnd = prev.x + prev.w;
+		if (skyline[i].x >= prevEnd)
+		{
+			break;
+		}
+		auto shrink = prevEnd - skyline[i].x;
+		skyline[i].x += shrink;
+		skyline[i].w -= shrink;
+		if (skyline[i].w > 0)
+		{
+			break;
+		}
+		skyline.erase(skyline.begin() + i);
+	}
+
+	// merge neighbours at the same height
+	for (std::size_t i = 0; i + 1 < skyline.size();)
+	{
+		if (skyline[i].y == skyline[i + 1].y)
+		{
+			skyline[i].w += skyline[i + 1].w;
+			skyline.erase(skyline.begin() + i + 1);
+		}
+		else
+		{
+			++i;
+		}
+	}
+
+	page.usedArea += s.w * s.h;
+	++page.entries;
+	return p;
+}
+
+void Atlas::destroyTextures(std::vector<Page>& of) noexcept
+{
+	if (alive.expired())
+	{
+		return;  // destroyed along with the renderer
+	}
+	for (auto& page: of)
+	{
+		SDL_DestroyTexture(page.texture);
+		SDLPP_PROFILE_COUNT(TextureDestructions, 1);
+	}
+}
+
+void Atlas::upload(Page& page, Rect r)
+{
+	auto surface = page.pixels.get();
+	SDL_Rect rect = r;
+	auto pixels = static_cast<std::uint8_t*>(surface->pixels)
+		+ r.p.y * surface->pitch + r.p.x * surface->format->BytesPerPixel;
+	if (SDL_UpdateTexture(page.texture, &rect, pixels, surface->pitch) < 0)
+	{
+		throw Error{SDL_GetError()};
+	}
+	SDLPP_PROFILE_COUNT(TextureUploads, 1);
+}
+}
@@ -0,0 +1,91 @@
+#include "sdlpp/dispatcher.h"
+
+#include <algorithm>
+
+namespace SDL
+{
+void EventDispatcher::subscribe(EventType type, Handler handler)
+{
+	byType[index(type)].push_back(std::move(handler));
+}
+
+void EventDispatcher::subscribe(EventType type, std::uint32_t windowId, Handler handler)
+{
+	if (windowId >= byWindow.size())
+	{
+		byWindow.resize(windowId + 1);
+	}
+	byWindow[windowId][index(type)].push_back(std::move(handler));
+}
+
+void EventDispatcher::subscribeBatch(EventType type, BatchHandler handler)
+{
+	batchByType[index(type)].push_back(std::move(handler));
+}
+
+void EventDispatcher::dispatch(Event const& ev)
+{
+	dispatchRun({&ev, 1});
+}
+
+void EventDispatcher::dispatch(std::span<Event const> evs)
+{
+	while (not evs.empty())
+	{
+		std::size_t length = 1;
+		while (length < evs.size() and evs[length].type == evs.front().type)
+		{
+			++length;
+		}
+		dispatchRun(evs.first(length));
+		evs = evs.subspan(length);
+	}
+}
+
+std::size_t EventDispatcher::drain(EventQueue& queue, std::size_t max)
+{
+	drained.clear();
+	auto limit = std::min(queue.size(), max);
+	while (drained.size() < limit and queue.pop_many(drained, std::min<std::size_t>(limit - drained.size(), 256)) != 0)
+	{}
+	dispatch(drained);
+	return drained.size();
+}
+
+void EventDispatcher::dispatchRun(std::span<Event const> run)
+{
+	auto type = index(run.front().type);
+
+	for (auto const& handler: batchByType[type])
+	{
+		handler(run);
+	}
+
+	auto const& handlers = byType[type];
+	auto hasWindowHandlers = not byWindow.empty();
+	if (handlers.empty() and not hasWindowHandlers)
+	{
+		return;
+	}
+
+	for (auto const& ev: run)
+	{
+		for (auto const& handler: handlers)
+		{
+			handler(ev);
+		}
+
+		if (hasWindowHandlers)
+		{
+			auto windowId = ev.windowId();
+			if (windowId != 0 and windowId < byWindow.size())
+			{
+				for (auto const& handler: byWindow[windowId][type])
+				{
+					handler(ev);
+				}
+			}
+		}
+	}
+}
+}
@@ -1,19 +1,62 @@
 #include "sdlpp/font.h"
 
+#include <algorithm>
+
+#include "sdlpp/archive.h"
 #include "sdlpp/error.h"
 #include "sdlpp/pixel.h"
+#include "sdlpp/profiler.h"
 #include "sdlpp/surface.h"
 
 using namespace std::literals;
 
 namespace SDL
 {
-Font::Font(std::string file_, int ptsize)
-	: file{file_}
+namespace
+{
+std::vector<std::byte> readFile(std::string const& file)
+{
+	auto rw = SDL_RWFromFile(file.c_str(), "rb");
+	if (rw == nullptr)
+	{
+		throw Error{SDL_GetError()};
+	}
+
+	auto size = SDL_RWsize(rw);
+	if (size < 0)
+	{
+		SDL_RWclose(rw);
+		throw Error{SDL_GetError()};
+	}
+
+	std::vector<std::byte> contents(static_cast<std::size_t>(size));
+	auto read = SDL_RWread(rw, contents.data(), 1, contents.size());
+	SDL_RWclose(rw);
+	if (read != contents.size())
+	{
+		throw Error{"Failed to read font file " + file};
+	}
+	return contents;
+}
+}
+
+Font::Font(std::string file, int ptsize)
+	: storage{readFile(file)}
+	, data{storage}
+{
+	addSize(ptsize);
+}
+
+Font::Font(std::span<std::byte const> data_, int ptsize)
+	: data{data_}
 {
 	addSize(ptsize);
 }
 
+Font::Font(Archive const& archive, std::string_view name, int ptsize)
+	: Font{archive.at(name).data, ptsize}
+{}
+
 Font::~Font() noexcept
 {
 	release();
@@ -22,8 +65,10 @@ Font::~Font() noexcept
 Font::Font(Font&& other) noexcept
 {
 	std::unique_lock<std::mutex> otherPin{other.mutex};
-	file = std::move(other.file);
+	storage = std::move(other.storage);
+	data = other.data;
 	fonts = std::move(other.fonts);
+	glyphs = std::move(other.glyphs);
 }
 
 Font& Font::operator=(Font&& other) noexcept
@@ -35,30 +80,52 @@ Font& Font::operator=(Font&& other) noexcept
 
 		release();
 	
-		file = std::move(other.file);
+		storage = std::move(other.storage);
+		data = other.data;
 		fonts = std::move(other.fonts);
+		glyphs = std::move(other.glyphs);
 	}
 
 	return *this;
 }
 
-void Font::addSize(int ptsize) const
+TTF_Font* Font::addSize(int ptsize) const
 {
 	std::unique_lock hold {mutex};
-	if (fonts.find(ptsize) == fonts.end())
+	if (auto it = fonts.find(ptsize); it != fonts.end())
 	{
-		fonts.insert({ptsize, TTF_OpenFont(file.c_str(), ptsize)});
-		if (fonts[ptsize] == nullptr)
-		{
-			throw Error{TTF_GetError()};
-		}
+		return it->second;
+	}
+
+	// every size is opened from the same in-memory copy of the font
+	auto rw = SDL_RWFromConstMem(data.data(), static_cast<int>(data.size()));
+	if (rw == nullptr)
+	{
+		throw Error{SDL_GetError()};
 	}
+	// closes rw even on failure
+	auto font = TTF_OpenFontRW(rw, 1, ptsize);
+	if (font == nullptr)
+	{
+		throw Error{TTF_GetError()};
+	}
+	try
+	{
+		fonts.insert({ptsize, font});
+	}
+	catch (...)
+	{
+		TTF_CloseFont(font);
+		throw;
+	}
+	return font;
 }
 
 Surface Font::render(std::string text, int ptsize, Color color) const
 {
-	addSize(ptsize);
-	auto s = TTF_RenderUTF8_Blended(fonts[ptsize], text.c_str(), color);
+	SDLPP_PROFILE_ZONE("Font::render");
+	SDLPP_PROFILE_COUNT(FontRasterizations, 1);
+	auto s = TTF_RenderUTF8_Blended(addSize(ptsize), text.c_str(), color);
 	if (s == nullptr)
 	{
 		if (TTF_GetError() == "Text has zero width"s)  // vexing exception workaround
@@ -72,8 +139,9 @@ Surface Font::render(std::string text, int ptsize, Color color) const
 
 Surface Font::renderWrapped(std::string text, int ptsize, unsigned int width, Color color) const
 {
-	addSize(ptsize);
-	auto s = TTF_RenderUTF8_Blended_Wrapped(fonts[ptsize], text.c_str(), color, width);
+	SDLPP_PROFILE_ZONE("Font::renderWrapped");
+	SDLPP_PROFILE_COUNT(FontRasterizations, 1);
+	auto s = TTF_RenderUTF8_Blended_Wrapped(addSize(ptsize), text.c_str(), color, width);
 	if (s == nullptr)
 	{
 		if (TTF_GetError() == "Text has zero width"s)  // vexing exception workaround
@@ -85,6 +153,148 @@ Surface Font::renderWrapped(std::string text, int ptsize, unsigned int width, Co
 	return s;
 }
 
+namespace
+{
+constexpr char32_t replacementCharacter = 0xFFFD;
+
+char32_t decodeUtf8(std::string_view text, std::size_t& i) noexcept
+{
+	auto byte = [&](std::size_t k) { return static_cast<unsigned char>(text[k]); };
+
+	auto lead = byte(i++);
+	if (lead < 0x80)
+	{
+		return lead;
+	}
+
+	int length;
+	char32_t cp;
+	if ((lead & 0xE0) == 0xC0)
+	{
+		length = 1;
+		cp = lead & 0x1F;
+	}
+	else if ((lead & 0xF0) == 0xE0)
+	{
+		length = 2;
+		cp = lead & 0x0F;
+	}
+	else if ((lead & 0xF8) == 0xF0)
+	{
+		length = 3;
+		cp = lead & 0x07;
+	}
+	else
+	{
+		return replacementCharacter;
+	}
+
+	for (int k = 0; k < length; ++k)
+	{
+		if (i >= text.size() or (byte(i) & 0xC0) != 0x80)
+		{
+			return replacementCharacter;
+		}
+		cp = (cp << 6) | (byte(i++) & 0x3F);
+	}
+	return cp;
+}
+}
+
+Font::Glyph& Font::getGlyph(char32_t codepoint, int ptsize) const
+{
+	auto font = addSize(ptsize);
+
+	std::unique_lock hold{mutex};
+	auto key = glyphKey(codepoint, ptsize);
+	if (auto it = glyphs.find(key); it != glyphs.end())
+	{
+		return it->second;
+	}
+
+	GlyphMetrics m;
+	if (TTF_GlyphMetrics32(font, codepoint, &m.minx, &m.maxx, &m.miny, &m.maxy, &m.advance) < 0)
+	{
+		throw Error{TTF_GetError()};
+	}
+	return glyphs.insert({key, Glyph{m, nullptr}}).first->second;
+}
+
+Surface const& Font::renderGlyph(char32_t codepoint, int ptsize) const
+{
+	auto& glyph = getGlyph(codepoint, ptsize);
+	auto font = addSize(ptsize);
+
+	std::unique_lock hold{mutex};
+	if (glyph.surface == nullptr)
+	{
+		SDLPP_PROFILE_COUNT(FontRasterizations, 1);
+		auto s = TTF_RenderGlyph32_Blended(font, codepoint, Color::White);
+		if (s == nullptr)
+		{
+			if (TTF_GetError() != "Text has zero width"s)
+			{
+				throw Error{TTF_GetError()};
+			}
+			glyph.surface = std::make_unique<Surface>(Size{1, 1});
+		}
+		else
+		{
+			glyph.surface = std::make_unique<Surface>(s);
+		}
+	}
+	return *glyph.surface;
+}
+
+GlyphMetrics Font::glyphMetrics(char32_t codepoint, int ptsize) const
+{
+	return getGlyph(codepoint, ptsize).metrics;
+}
+
+std::vector<GlyphQuad> Font::layout(std::string_view text, int ptsize) const
+{
+	std::vector<GlyphQuad> quads;
+	layout(text, ptsize, quads);
+	return quads;
+}
+
+void Font::layout(std::string_view text, int ptsize, std::vector<GlyphQuad>& out) const
+{
+	out.clear();
+	auto font = addSize(ptsize);
+	auto height = TTF_FontHeight(font);
+	auto lineSkip = TTF_FontLineSkip(font);
+
+	Point pen{0, 0};
+	char32_t previous = 0;
+	for (std::size_t i = 0; i < text.size();)
+	{
+		auto codepoint = decodeUtf8(text, i);
+		if (codepoint == U'\n')
+		{
+			pen = {0, pen.y + lineSkip};
+			previous = 0;
+			continue;
+		}
+
+		auto m = glyphMetrics(codepoint, ptsize);
+		if (previous != 0)
+		{
+			pen.x += TTF_GetFontKerningSizeGlyphs32(font, previous, codepoint);
+		}
+		previous = codepoint;
+
+		if (m.maxx > m.minx)
+		{
+			// same box TTF_RenderGlyph32_Blended produces for the glyph
+			auto left = std::min(0, m.minx);
+			auto right = std::max(m.maxx, m.advance);
+			out.push_back({codepoint, {{pen.x + left, pen.y}, {right - left, height}}});
+		}
+		pen.x += m.advance;
+	}
+}
+
 void Font::release() noexcept
 {
 	for (auto&& [_, font]: fonts)
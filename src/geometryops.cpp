@@ -0,0 +1,645 @@
+#include "sdlpp/geometryops.h"
+
+#include <algorithm>
+#include <bit>
+#include <climits>
+#include <cstring>
+
+#include "sdlpp/pixelops.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SDLPP_GEOMETRYOPS_X86 1
+#include <immintrin.h>
+#endif
+
+namespace SDL::GeometryOps
+{
+namespace
+{
+struct Rects
+{
+	int const* x;
+	int const* y;
+	int const* w;
+	int const* h;
+
+	Rect operator[](std::size_t i) const noexcept
+	{
+		return {{x[i], y[i]}, {w[i], h[i]}};
+	}
+
+	Rects operator+(std::size_t i) const noexcept
+	{
+		return {x + i, y + i, w + i, h + i};
+	}
+};
+
+struct OutRects
+{
+	int* x;
+	int* y;
+	int* w;
+	int* h;
+
+	void set(std::size_t i, Rect r) const noexcept
+	{
+		x[i] = r.p.x;
+		y[i] = r.p.y;
+		w[i] = r.s.w;
+		h[i] = r.s.h;
+	}
+
+	OutRects operator+(std::size_t i) const noexcept
+	{
+		return {x + i, y + i, w + i, h + i};
+	}
+};
+
+/* How far alignment moves a coordinate along one axis: out = base + size *
+ * factor, where factor is 0, 1/2 (rounded towards zero, like the scalar code)
+ * or 1, and negated for alignRects. */
+enum class Shift: std::uint8_t
+{
+	None, Half, Full,
+};
+
+Shift shiftFor(VerticalAlignment v) noexcept
+{
+	switch (v)
+	{
+		case VerticalAlignment::Top: return Shift::None;
+		case VerticalAlignment::Middle: return Shift::Half;
+		case VerticalAlignment::Bottom: return Shift::Full;
+	}
+	return Shift::None;
+}
+
+Shift shiftFor(HorizontalAlignment h) noexcept
+{
+	switch (h)
+	{
+		case HorizontalAlignment::Left: return Shift::None;
+		case HorizontalAlignment::Center: return Shift::Half;
+		case HorizontalAlignment::Right: return Shift::Full;
+	}
+	return Shift::None;
+}
+
+/* Scalar kernels, written in terms of the geometry.h operations they mirror */
+
+void shiftScalar(int const* base, int const* size, int* out, std::size_t n, Shift shift, bool subtract) noexcept
+{
+	for (std::size_t i = 0; i < n; ++i)
+	{
+		auto d = shift == Shift::None ? 0 : shift == Shift::Half ? size[i] / 2 : size[i];
+		out[i] = subtract ? base[i] - d : base[i] + d;
+	}
+}
+
+std::size_t containsPointsScalar(Rect r, int const* x, int const* y, std::uint8_t* out, std::size_t n) noexcept
+{
+	std::size_t count = 0;
+	for (std::size_t i = 0; i < n; ++i)
+	{
+		auto in = Point{x[i], y[i]}.in(r);
+		out[i] = in;
+		count += in;
+	}
+	return count;
+}
+
+std::size_t rectsContainingScalar(Rects rects, Point p, std::uint8_t* out, std::size_t n) noexcept
+{
+	std::size_t count = 0;
+	for (std::size_t i = 0; i < n; ++i)
+	{
+		auto in = p.in(rects[i]);
+		out[i] = in;
+		count += in;
+	}
+	return count;
+}
+
+std::size_t intersectScalar(Rects rects, Rect r, std::uint8_t* out, std::size_t n) noexcept
+{
+	std::size_t count = 0;
+	for (std::size_t i = 0; i < n; ++i)
+	{
+		auto hit = rects[i].intersects(r);
+		out[i] = hit;
+		count += hit;
+	}
+	return count;
+}
+
+Rect unionScalar(Rects rects, std::size_t n, Rect bounds) noexcept
+{
+	for (std::size_t i = 0; i < n; ++i)
+	{
+		bounds = bounds.united(rects[i]);
+	}
+	return bounds;
+}
+
+Rect unionScalar(Rects rects, std::size_t n) noexcept
+{
+	return unionScalar(rects, n, {{0, 0}, {0, 0}});
+}
+
+void clipScalar(Rects rects, Rect area, OutRects out, std::size_t n) noexcept
+{
+	for (std::size_t i = 0; i < n; ++i)
+	{
+		out.set(i, rects[i].clipped(area));
+	}
+}
+
+/* Bounds of the non-empty rects as running extremes; empty rects contribute
+ * the identity values, so no lane needs a branch. */
+struct Extremes
+{
+	int x0 = INT_MAX;
+	int y0 = INT_MAX;
+	int x1 = INT_MIN;
+	int y1 = INT_MIN;
+
+	Rect toRect() const noexcept
+	{
+		// a non-empty rect always ends right of INT_MIN
+		if (x1 == INT_MIN)
+		{
+			return {{0, 0}, {0, 0}};
+		}
+		return {{x0, y0}, {x1 - x0, y1 - y0}};
+	}
+};
+
+#ifdef SDLPP_GEOMETRYOPS_X86
+/* SSE2 kernels, 4 elements per step */
+
+inline __m128i loadSse2(int const* p) noexcept
+{
+	return _mm_loadu_si128(reinterpret_cast<__m128i const*>(p));
+}
+
+inline void storeSse2(int* p, __m128i v) noexcept
+{
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(p), v);
+}
+
+inline __m128i selectSse2(__m128i mask, __m128i a, __m128i b) noexcept
+{
+	return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+// SSE2 has no 32-bit min and max, those came with SSE4.1
+inline __m128i minSse2(__m128i a, __m128i b) noexcept
+{
+	return selectSse2(_mm_cmplt_epi32(a, b), a, b);
+}
+
+inline __m128i maxSse2(__m128i a, __m128i b) noexcept
+{
+	return selectSse2(_mm_cmpgt_epi32(a, b), a, b);
+}
+
+// v / 2 rounded towards zero
+inline __m128i halfSse2(__m128i v) noexcept
+{
+	return _mm_srai_epi32(_mm_add_epi32(v, _mm_srli_epi32(v, 31)), 1);
+}
+
+// writes 0 or 1 per lane and returns how many lanes were set
+inline std::size_t storeMaskSse2(__m128i mask, std::uint8_t* out) noexcept
+{
+	auto words = _mm_packs_epi32(mask, mask);
+	auto bytes = _mm_and_si128(_mm_packs_epi16(words, words), _mm_set1_epi8(1));
+	auto low = _mm_cvtsi128_si32(bytes);
+	std::memcpy(out, &low, 4);
+	return static_cast<std::size_t>(std::popcount(static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(mask)))));
+}
+
+void shiftSse2(int const* base, int const* size, int* out, std::size_t n, Shift shift, bool subtract) noexcept
+{
+	std::size_t i = 0;
+	for (; i + 4 <= n; i += 4)
+	{
+		auto s = loadSse2(size + i);
+		auto d = shift == Shift::None ? _mm_setzero_si128() : shift == Shift::Half ? halfSse2(s) : s;
+		auto b = loadSse2(base + i);
+		storeSse2(out + i, subtract ? _mm_sub_epi32(b, d) : _mm_add_epi32(b, d));
+	}
+	shiftScalar(base + i, size + i, out + i, n - i, shift, subtract);
+}
+
+std::size_t containsPointsSse2(Rect r, int const* x, int const* y, std::uint8_t* out, std::size_t n) noexcept
+{
+	auto zero = _mm_setzero_si128();
+	auto rx = _mm_set1_epi32(r.p.x);
+	auto ry = _mm_set1_epi32(r.p.y);
+	auto rw = _mm_set1_epi32(r.s.w);
+	auto rh = _mm_set1_epi32(r.s.h);
+	std::size_t count = 0;
+	std::size_t i = 0;
+	for (; i + 4 <= n; i += 4)
+	{
+		auto dx = _mm_sub_epi32(loadSse2(x + i), rx);
+		auto dy = _mm_sub_epi32(loadSse2(y + i), ry);
+		auto in = _mm_and_si128(
+			_mm_andnot_si128(_mm_cmplt_epi32(dx, zero), _mm_cmplt_epi32(dx, rw)),
+			_mm_andnot_si128(_mm_cmplt_epi32(dy, zero), _mm_cmplt_epi32(dy, rh))
+		);
+		count += storeMaskSse2(in, out + i);
+	}
+	return count + containsPointsScalar(r, x + i, y + i, out + i, n - i);
+}
+
+std::size_t rectsContainingSse2(Rects rects, Point p, std::uint8_t* out, std::size_t n) noexcept
+{
+	auto zero = _mm_setzero_si128();
+	auto px = _mm_set1_epi32(p.x);
+	auto py = _mm_set1_epi32(p.y);
+	std::size_t count = 0;
+	std::size_t i = 0;
+	for (; i + 4 <= n; i += 4)
+	{
+		auto dx = _mm_sub_epi32(px, loadSse2(rects.x + i));
+		auto dy = _mm_sub_epi32(py, loadSse2(rects.y + i));
+		auto in = _mm_and_si128(
+			_mm_andnot_si128(_mm_cmplt_epi32(dx, zero), _mm_cmplt_epi32(dx, loadSse2(rects.w + i))),
+			_mm_andnot_si128(_mm_cmplt_epi32(dy, zero), _mm_cmplt_epi32(dy, loadSse2(rects.h + i)))
+		);
+		count += storeMaskSse2(in, out + i);
+	}
+	return count + rectsContainingScalar(rects + i, p, out + i, n - i);
+}
+
+// r must not be empty, the caller handles that case
+std::size_t intersectSse2(Rects rects, Rect r, std::uint8_t* out, std::size_t n) noexcept
+{
+	auto zero = _mm_setzero_si128();
+	auto rx0 = _mm_set1_epi32(r.p.x);
+	auto ry0 = _mm_set1_epi32(r.p.y);
+	auto rx1 = _mm_set1_epi32(r.p.x + r.s.w);
+	auto ry1 = _mm_set1_epi32(r.p.y + r.s.h);
+	std::size_t count = 0;
+	std::size_t i = 0;
+	for (; i + 4 <= n; i += 4)
+	{
+		auto x = loadSse2(rects.x + i);
+		auto y = loadSse2(rects.y + i);
+		auto w = loadSse2(rects.w + i);
+		auto h = loadSse2(rects.h + i);
+		auto hitX = _mm_and_si128(_mm_cmplt_epi32(x, rx1), _mm_cmplt_epi32(rx0, _mm_add_epi32(x, w)));
+		auto hitY = _mm_and_si128(_mm_cmplt_epi32(y, ry1), _mm_cmplt_epi32(ry0, _mm_add_epi32(y, h)));
+		auto nonEmpty = _mm_and_si128(_mm_cmpgt_epi32(w, zero), _mm_cmpgt_epi32(h, zero));
+		count += storeMaskSse2(_mm_and_si128(_mm_and_si128(hitX, hitY), nonEmpty), out + i);
+	}
+	return count + intersectScalar(rects + i, r, out + i, n - i);
+}
+
+Rect unionSse2(Rects rects, std::size_t n) noexcept
+{
+	auto zero = _mm_setzero_si128();
+	auto lowest = _mm_set1_epi32(INT_MIN);
+	auto highest = _mm_set1_epi32(INT_MAX);
+	auto x0 = highest;
+	auto y0 = highest;
+	auto x1 = lowest;
+	auto y1 = lowest;
+	std::size_t i = 0;
+	for (; i + 4 <= n; i += 4)
+	{
+		auto x = loadSse2(rects.x + i);
+		auto y = loadSse2(rects.y + i);
+		auto w = loadSse2(rects.w + i);
+		auto h = loadSse2(rects.h + i);
+		auto nonEmpty = _mm_and_si128(_mm_cmpgt_epi32(w, zero), _mm_cmpgt_epi32(h, zero));
+		x0 = minSse2(x0, selectSse2(nonEmpty, x, highest));
+		y0 = minSse2(y0, selectSse2(nonEmpty, y, highest));
+		x1 = maxSse2(x1, selectSse2(nonEmpty, _mm_add_epi32(x, w), lowest));
+		y1 = maxSse2(y1, selectSse2(nonEmpty, _mm_add_epi32(y, h), lowest));
+	}
+
+	alignas(16) int lanes[4][4];
+	storeSse2(lanes[0], x0);
+	storeSse2(lanes[1], y0);
+	storeSse2(lanes[2], x1);
+	storeSse2(lanes[3], y1);
+	Extremes e;
+	for (int l = 0; l < 4; ++l)
+	{
+		e.x0 = std::min(e.x0, lanes[0][l]);
+		e.y0 = std::min(e.y0, lanes[1][l]);
+		e.x1 = std::max(e.x1, lanes[2][l]);
+		e.y1 = std::max(e.y1, lanes[3][l]);
+	}
+	return unionScalar(rects + i, n - i, e.toRect());
+}
+
+void clipSse2(Rects rects, Rect area, OutRects out, std::size_t n) noexcept
+{
+	auto zero = _mm_setzero_si128();
+	auto ax0 = _mm_set1_epi32(area.p.x);
+	auto ay0 = _mm_set1_epi32(area.p.y);
+	auto ax1 = _mm_set1_epi32(area.p.x + area.s.w);
+	auto ay1 = _mm_set1_epi32(area.p.y + area.s.h);
+	std::size_t i = 0;
+	for (; i + 4 <= n; i += 4)
+	{
+		auto x = loadSse2(rects.x + i);
+		auto y = loadSse2(rects.y + i);
+		auto x0 = maxSse2(x, ax0);
+		auto y0 = maxSse2(y, ay0);
+		auto x1 = minSse2(_mm_add_epi32(x, loadSse2(rects.w + i)), ax1);
+		auto y1 = minSse2(_mm_add_epi32(y, loadSse2(rects.h + i)), ay1);
+		storeSse2(out.x + i, x0);
+		storeSse2(out.y + i, y0);
+		storeSse2(out.w + i, maxSse2(_mm_sub_epi32(x1, x0), zero));
+		storeSse2(out.h + i, maxSse2(_mm_sub_epi32(y1, y0), zero));
+	}
+	clipScalar(rects + i, area, out + i, n - i);
+}
+
+/* AVX2 kernels, 8 elements per step */
+
+#define SDLPP_AVX2 __attribute__((target("avx2")))
+
+SDLPP_AVX2 inline __m256i loadAvx2(int const* p) noexcept
+{
+	return _mm256_loadu_si256(reinterpret_cast<__m256i const*>(p));
+}
+
+SDLPP_AVX2 inline void storeAvx2(int* p, __m256i v) noexcept
+{
+	_mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v);
+}
+
+SDLPP_AVX2 inline __m256i lessAvx2(__m256i a, __m256i b) noexcept
+{
+	return _mm256_cmpgt_epi32(b, a);
+}
+
+SDLPP_AVX2 inline std::size_t storeMaskAvx2(__m256i mask, std::uint8_t* out) noexcept
+{
+	auto words = _mm_packs_epi32(_mm256_castsi256_si128(mask), _mm256_extracti128_si256(mask, 1));
+	auto bytes = _mm_and_si128(_mm_packs_epi16(words, words), _mm_set1_epi8(1));
+	_mm_storel_epi64(reinterpret_cast<__m128i*>(out), bytes);
+	return static_cast<std::size_t>(std::popcount(static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(mask)))));
+}
+
+SDLPP_AVX2 void shiftAvx2(int const* base, int const* size, int* out, std::size_t n, Shift shift, bool subtract) noexcept
+{
+	std::size_t i = 0;
+	for (; i + 8 <= n; i += 8)
+	{
+		auto s = loadAvx2(size + i);
+		auto d = shift == Shift::None ? _mm256_setzero_si256()
+			: shift == Shift::Half ? _mm256_srai_epi32(_mm256_add_epi32(s, _mm256_srli_epi32(s, 31)), 1)
+			: s;
+		auto b = loadAvx2(base + i);
+		storeAvx2(out + i, subtract ? _mm256_sub_epi32(b, d) : _mm256_add_epi32(b, d));
+	}
+	shiftSse2(base + i, size + i, out + i, n - i, shift, subtract);
+}
+
+SDLPP_AVX2 std::size_t containsPointsAvx2(Rect r, int const* x, int const* y, std::uint8_t* out, std::size_t n) noexcept
+{
+	auto zero = _mm256_setzero_si256();
+	auto rx = _mm256_set1_epi32(r.p.x);
+	auto ry = _mm256_set1_epi32(r.p.y);
+	auto rw = _mm256_set1_epi32(r.s.w);
+	auto rh = _mm256_set1_epi32(r.s.h);
+	std::size_t count = 0;
+	std::size_t i = 0;
+	for (; i + 8 <= n; i += 8)
+	{
+		auto dx = _mm256_sub_epi32(loadAvx2(x + i), rx);
+		auto dy = _mm256_sub_epi32(loadAvx2(y + i), ry);
+		auto in = _mm256_and_si256(
+			_mm256_andnot_si256(lessAvx2(dx, zero), lessAvx2(dx, rw)),
+			_mm256_andnot_si256(lessAvx2(dy, zero), lessAvx2(dy, rh))
+		);
+		count += storeMaskAvx2(in, out + i);
+	}
+	return count + containsPointsSse2(r, x + i, y + i, out + i, n - i);
+}
+
+SDLPP_AVX2 std::size_t rectsContainingAvx2(Rects rects, Point p, std::uint8_t* out, std::size_t n) noexcept
+{
+	auto zero = _mm256_setzero_si256();
+	auto px = _mm256_set1_epi32(p.x);
+	auto py = _mm256_set1_epi32(p.y);
+	std::size_t count = 0;
+	std::size_t i = 0;
+	for (; i + 8 <= n; i += 8)
+	{
+		auto dx = _mm256_sub_epi32(px, loadAvx2(rects.x + i));
+		auto dy = _mm256_sub_epi32(py, loadAvx2(rects.y + i));
+		auto in = _mm256_and_si256(
+			_mm256_andnot_si256(lessAvx2(dx, zero), lessAvx2(dx, loadAvx2(rects.w + i))),
+			_mm256_andnot_si256(lessAvx2(dy, zero), lessAvx2(dy, loadAvx2(rects.h + i)))
+		);
+		count += storeMaskAvx2(in, out + i);
+	}
+	return count + rectsContainingSse2(rects + i, p, out + i, n - i);
+}
+
+SDLPP_AVX2 std::size_t intersectAvx2(Rects rects, Rect r, std::uint8_t* out, std::size_t n) noexcept
+{
+	auto zero = _mm256_setzero_si256();
+	auto rx0 = _mm256_set1_epi32(r.p.x);
+	auto ry0 = _mm256_set1_epi32(r.p.y);
+	auto rx1 = _mm256_set1_epi32(r.p.x + r.s.w);
+	auto ry1 = _mm256_set1_epi32(r.p.y + r.s.h);
+	std::size_t count = 0;
+	std::size_t i = 0;
+	for (; i + 8 <= n; i += 8)
+	{
+		auto x = loadAvx2(rects.x + i);
+		auto y = loadAvx2(rects.y + i);
+		auto w = loadAvx2(rects.w + i);
+		auto h = loadAvx2(rects.h + i);
+		auto hitX = _mm256_and_si256(lessAvx2(x, rx1), lessAvx2(rx0, _mm256_add_epi32(x, w)));
+		auto hitY = _mm256_and_si256(lessAvx2(y, ry1), lessAvx2(ry0, _mm256_add_epi32(y, h)));
+		auto nonEmpty = _mm256_and_si256(_mm256_cmpgt_epi32(w, zero), _mm256_cmpgt_epi32(h, zero));
+		count += storeMaskAvx2(_mm256_and_si256(_mm256_and_si256(hitX, hitY), nonEmpty), out + i);
+	}
+	return count + intersectSse2(rects + i, r, out + i, n - i);
+}
+
+SDLPP_AVX2 Rect unionAvx2(Rects rects, std::size_t n) noexcept
+{
+	auto zero = _mm256_setzero_si256();
+	auto lowest = _mm256_set1_epi32(INT_MIN);
+	auto highest = _mm256_set1_epi32(INT_MAX);
+	auto x0 = highest;
+	auto y0 = highest;
+	auto x1 = lowest;
+	auto y1 = lowest;
+	std::size_t i = 0;
+	for (; i + 8 <= n; i += 8)
+	{
+		auto x = loadAvx2(rects.x + i);
+		auto y = loadAvx2(rects.y + i);
+		auto w = loadAvx2(rects.w + i);
+		auto h = loadAvx2(rects.h + i);
+		auto nonEmpty = _mm256_and_si256(_mm256_cmpgt_epi32(w, zero), _mm256_cmpgt_epi32(h, zero));
+		x0 = _mm256_min_epi32(x0, _mm256_blendv_epi8(highest, x, nonEmpty));
+		y0 = _mm256_min_epi32(y0, _mm256_blendv_epi8(highest, y, nonEmpty));
+		x1 = _mm256_max_epi32(x1, _mm256_blendv_epi8(lowest, _mm256_add_epi32(x, w), nonEmpty));
+		y1 = _mm256_max_epi32(y1, _mm256_blendv_epi8(lowest, _mm256_add_epi32(y, h), nonEmpty));
+	}
+
+	alignas(32) int lanes[4][8];
+	storeAvx2(lanes[0], x0);
+	storeAvx2(lanes[1], y0);
+	storeAvx2(lanes[2], x1);
+	storeAvx2(lanes[3], y1);
+	Extremes e;
+	for (int l = 0; l < 8; ++l)
+	{
+		e.x0 = std::min(e.x0, lanes[0][l]);
+		e.y0 = std::min(e.y0, lanes[1][l]);
+		e.x1 = std::max(e.x1, lanes[2][l]);
+		e.y1 = std::max(e.y1, lanes[3][l]);
+	}
+	return unionScalar(rects + i, n - i, e.toRect());
+}
+
+SDLPP_AVX2 void clipAvx2(Rects rects, Rect area, OutRects out, std::size_t n) noexcept
+{
+	auto zero = _mm256_setzero_si256();
+	auto ax0 = _mm256_set1_epi32(area.p.x);
+	auto ay0 = _mm256_set1_epi32(area.p.y);
+	auto ax1 = _mm256_set1_epi32(area.p.x + area.s.w);
+	auto ay1 = _mm256_set1_epi32(area.p.y + area.s.h);
+	std::size_t i = 0;
+	for (; i + 8 <= n; i += 8)
+	{
+		auto x = loadAvx2(rects.x + i);
+		auto y = loadAvx2(rects.y + i);
+		auto x0 = _mm256_max_epi32(x, ax0);
+		auto y0 = _mm256_max_epi32(y, ay0);
+		auto x1 = _mm256_min_epi32(_mm256_add_epi32(x, loadAvx2(rects.w + i)), ax1);
+		auto y1 = _mm256_min_epi32(_mm256_add_epi32(y, loadAvx2(rects.h + i)), ay1);
+		storeAvx2(out.x + i, x0);
+		storeAvx2(out.y + i, y0);
+		storeAvx2(out.w + i, _mm256_max_epi32(_mm256_sub_epi32(x1, x0), zero));
+		storeAvx2(out.h + i, _mm256_max_epi32(_mm256_sub_epi32(y1, y0), zero));
+	}
+	clipSse2(rects + i, area, out + i, n - i);
+}
+
+#undef SDLPP_AVX2
+#endif
+
+struct Kernels
+{
+	void (*shift)(int const*, int const*, int*, std::size_t, Shift, bool) noexcept;
+	std::size_t (*containsPoints)(Rect, int const*, int const*, std::uint8_t*, std::size_t) noexcept;
+	std::size_t (*rectsContaining)(Rects, Point, std::uint8_t*, std::size_t) noexcept;
+	std::size_t (*intersect)(Rects, Rect, std::uint8_t*, std::size_t) noexcept;
+	Rect (*unionBounds)(Rects, std::size_t) noexcept;
+	void (*clip)(Rects, Rect, OutRects, std::size_t) noexcept;
+};
+
+constexpr Kernels scalarKernels{
+	shiftScalar, containsPointsScalar, rectsContainingScalar, intersectScalar, unionScalar, clipScalar
+};
+#ifdef SDLPP_GEOMETRYOPS_X86
+constexpr Kernels sse2Kernels{shiftSse2, containsPointsSse2, rectsContainingSse2, intersectSse2, unionSse2, clipSse2};
+constexpr Kernels avx2Kernels{shiftAvx2, containsPointsAvx2, rectsContainingAvx2, intersectAvx2, unionAvx2, clipAvx2};
+#endif
+
+Kernels const& active() noexcept
+{
+	switch (PixelOps::activeIsa())
+	{
+#ifdef SDLPP_GEOMETRYOPS_X86
+		case PixelOps::Isa::AVX2:
+			return avx2Kernels;
+		case PixelOps::Isa::SSE2:
+			return sse2Kernels;
+#endif
+		default:
+			return scalarKernels;
+	}
+}
+
+std::size_t count(ConstPointSpan s) noexcept
+{
+	return std::min(s.x.size(), s.y.size());
+}
+
+std::size_t count(ConstRectSpan s) noexcept
+{
+	return std::min({s.x.size(), s.y.size(), s.w.size(), s.h.size()});
+}
+
+Rects raw(ConstRectSpan s) noexcept
+{
+	return {s.x.data(), s.y.data(), s.w.data(), s.h.data()};
+}
+
+void copy(std::span<int const> from, std::span<int> to, std::size_t n) noexcept
+{
+	if (from.data() != to.data())
+	{
+		std::copy_n(from.begin(), n, to.begin());
+	}
+}
+}
+
+void alignRects(ConstRectSpan anchors, Alignment align, RectSpan out) noexcept
+{
+	auto n = std::min(count(anchors), count(ConstRectSpan{out}));
+	auto const& k = active();
+	k.shift(anchors.x.data(), anchors.w.data(), out.x.data(), n, shiftFor(align.h), true);
+	k.shift(anchors.y.data(), anchors.h.data(), out.y.data(), n, shiftFor(align.v), true);
+	copy(anchors.w, out.w, n);
+	copy(anchors.h, out.h, n);
+}
+
+void alignedPoints(ConstRectSpan rects, Alignment align, PointSpan out) noexcept
+{
+	auto n = std::min(count(rects), count(ConstPointSpan{out}));
+	auto const& k = active();
+	k.shift(rects.x.data(), rects.w.data(), out.x.data(), n, shiftFor(align.h), false);
+	k.shift(rects.y.data(), rects.h.data(), out.y.data(), n, shiftFor(align.v), false);
+}
+
+std::size_t containsPoints(Rect r, ConstPointSpan points, std::span<std::uint8_t> out) noexcept
+{
+	auto n = std::min(count(points), out.size());
+	return active().containsPoints(r, points.x.data(), points.y.data(), out.data(), n);
+}
+
+std::size_t rectsContaining(ConstRectSpan rects, Point p, std::span<std::uint8_t> out) noexcept
+{
+	auto n = std::min(count(rects), out.size());
+	return active().rectsContaining(raw(rects), p, out.data(), n);
+}
+
+std::size_t intersectRects(ConstRectSpan rects, Rect r, std::span<std::uint8_t> out) noexcept
+{
+	auto n = std::min(count(rects), out.size());
+	if (r.s.w <= 0 or r.s.h <= 0)
+	{
+		std::fill_n(out.begin(), n, std::uint8_t{0});
+		return 0;
+	}
+	return active().intersect(raw(rects), r, out.data(), n);
+}
+
+Rect unionBounds(ConstRectSpan rects) noexcept
+{
+	return active().unionBounds(raw(rects), count(rects));
+}
+
+void clipRects(ConstRectSpan rects, Rect area, RectSpan out) noexcept
+{
+	auto n = std::min(count(rects), count(ConstRectSpan{out}));
+	active().clip(raw(rects), area, {out.x.data(), out.y.data(), out.w.data(), out.h.data()}, n);
+}
+}
@@ -0,0 +1,30 @@
+#include "sdlpp/glyphatlas.h"
+
+#include "sdlpp/surface.h"
+
+namespace SDL
+{
+GlyphAtlas::GlyphAtlas(Font const& font_, Renderer& renderer, Size pageSize)
+	: font{font_}
+	, atlas{renderer, pageSize}
+{}
+
+AtlasHandle GlyphAtlas::get(char32_t codepoint, int ptsize)
+{
+	auto key = glyphKey(codepoint, ptsize);
+	if (auto it = handles.find(key); it != handles.end())
+	{
+		return it->second;
+	}
+
+	auto h = atlas.insert(font.renderGlyph(codepoint, ptsize));
+	handles.insert({key, h});
+	return h;
+}
+
+std::span<GlyphQuad const> GlyphAtlas::layout(std::string_view text, int ptsize)
+{
+	font.layout(text, ptsize, quads);
+	return quads;
+}
+}
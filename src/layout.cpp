@@ -0,0 +1,438 @@
+#include "sdlpp/layout.h"
+
+#include <algorithm>
+
+#include "sdlpp/error.h"
+
+namespace SDL
+{
+namespace
+{
+bool same(OptionalSize a, OptionalSize b) noexcept
+{
+	return a.w == b.w and a.h == b.h;
+}
+
+bool same(Alignment a, Alignment b) noexcept
+{
+	return a.v == b.v and a.h == b.h;
+}
+
+bool same(auto a, auto b) noexcept
+{
+	return a == b;
+}
+
+std::optional<int> shrink(std::optional<int> v, int by) noexcept
+{
+	if (not v)
+	{
+		return std::nullopt;
+	}
+	return std::max(*v - by, 0);
+}
+
+int limit(int v, std::optional<int> bound) noexcept
+{
+	return bound ? std::min(v, *bound) : v;
+}
+
+Size limit(Size s, OptionalSize bound) noexcept
+{
+	return {limit(s.w, bound.w), limit(s.h, bound.h)};
+}
+
+bool fits(Size s, OptionalSize bound) noexcept
+{
+	return limit(s, bound) == s;
+}
+
+// the extent along the stacking axis, and across it
+int& mainAxis(Size& s, Layout::Direction d) noexcept
+{
+	return d == Layout::Direction::Horizontal ? s.w : s.h;
+}
+
+int& crossAxis(Size& s, Layout::Direction d) noexcept
+{
+	return d == Layout::Direction::Horizontal ? s.h : s.w;
+}
+
+std::optional<int>& mainAxis(OptionalSize& s, Layout::Direction d) noexcept
+{
+	return d == Layout::Direction::Horizontal ? s.w : s.h;
+}
+
+int& mainAxis(Point& p, Layout::Direction d) noexcept
+{
+	return d == Layout::Direction::Horizontal ? p.x : p.y;
+}
+}
+
+Layout::Id Layout::addBox(std::optional<Id> parent)
+{
+	return add(parent, {});
+}
+
+Layout::Id Layout::addStack(std::optional<Id> parent, Direction direction, int spacing)
+{
+	Node node;
+	node.kind = Kind::Stack;
+	node.direction = direction;
+	node.spacing = spacing;
+	return add(parent, std::move(node));
+}
+
+Layout::Id Layout::addGrid(std::optional<Id> parent, int columns, int spacing)
+{
+	if (columns <= 0)
+	{
+		throw Error{"Invalid grid column count"};
+	}
+	Node node;
+	node.kind = Kind::Grid;
+	node.columns = columns;
+	node.spacing = spacing;
+	return add(parent, std::move(node));
+}
+
+Layout::Node& Layout::at(Id id)
+{
+	if (id >= nodes.size() or not nodes[id].alive)
+	{
+		throw Error{"Invalid layout node"};
+	}
+	return nodes[id];
+}
+
+Layout::Node const& Layout::at(Id id) const
+{
+	if (id >= nodes.size() or not nodes[id].alive)
+	{
+		throw Error{"Invalid layout node"};
+	}
+	return nodes[id];
+}
+
+Layout::Id Layout::add(std::optional<Id> parent, Node node)
+{
+	if (parent)
+	{
+		at(*parent);
+	}
+	node.parent = parent.value_or(none);
+
+	Id id;
+	if (not freeIds.empty())
+	{
+		id = freeIds.back();
+		freeIds.pop_back();
+		nodes[id] = std::move(node);
+	}
+	else
+	{
+		id = static_cast<Id>(nodes.size());
+		nodes.push_back(std::move(node));
+	}
+
+	if (parent)
+	{
+		nodes[*parent].children.push_back(id);
+		markDirty(*parent);
+	}
+	else
+	{
+		roots.push_back(id);
+	}
+	return id;
+}
+
+void Layout::remove(Id id)
+{
+	auto parent = at(id).parent;
+	auto& siblings = parent == none ? roots : nodes[parent].children;
+	siblings.erase(std::find(siblings.begin(), siblings.end(), id));
+	if (parent != none)
+	{
+		markDirty(parent);
+	}
+
+	std::vector<Id> pending{id};
+	while (not pending.empty())
+	{
+		auto next = pending.back();
+		pending.pop_back();
+		auto& n = nodes[next];
+		pending.insert(pending.end(), n.children.begin(), n.children.end());
+		n = {};
+		n.alive = false;
+		freeIds.push_back(next);
+	}
+}
+
+void Layout::setSize(Id id, OptionalSize size)
+{
+	change(id, &Node::size, size);
+}
+
+void Layout::setMinSize(Id id, Size size)
+{
+	change(id, &Node::minSize, size);
+}
+
+void Layout::setMaxSize(Id id, OptionalSize size)
+{
+	change(id, &Node::maxSize, size);
+}
+
+void Layout::setContentSize(Id id, Size size)
+{
+	change(id, &Node::contentSize, size);
+}
+
+void Layout::setAlignment(Id id, Alignment align)
+{
+	change(id, &Node::align, align);
+}
+
+void Layout::setPadding(Id id, int padding)
+{
+	change(id, &Node::padding, padding);
+}
+
+void Layout::setStretch(Id id, bool stretch)
+{
+	change(id, &Node::stretch, stretch);
+}
+
+template<typename T>
+void Layout::change(Id id, T Node::* field, T value)
+{
+	auto& slot = at(id).*field;
+	if (not same(slot, value))
+	{
+		slot = value;
+		markDirty(id);
+	}
+}
+
+void Layout::markDirty(Id id) noexcept
+{
+	while (id != none and not nodes[id].dirty)
+	{
+		nodes[id].dirty = true;
+		id = nodes[id].parent;
+	}
+}
+
+void Layout::invalidate() noexcept
+{
+	for (auto& n: nodes)
+	{
+		n.dirty = n.alive;
+	}
+}
+
+void Layout::update(Size viewport)
+{
+	stats = {};
+	for (auto root: roots)
+	{
+		measure(root, viewport);
+		arrange(root, {{0, 0}, viewport});
+	}
+}
+
+Rect Layout::getRect(Id id) const
+{
+	auto r = at(id).local;
+	for (auto p = nodes[id].parent; p != none; p = nodes[p].parent)
+	{
+		r.p = r.p + Vec2D(nodes[p].local.p);
+	}
+	return r;
+}
+
+std::size_t Layout::size() const noexcept
+{
+	return nodes.size() - freeIds.size();
+}
+
+Layout::Stats Layout::getStats() const noexcept
+{
+	return stats;
+}
+
+Size Layout::measure(Id id, OptionalSize available)
+{
+	auto& n = nodes[id];
+	if (n.measured and not n.dirty and (same(n.measuredFor, available) or (n.fitted and fits(n.desired, available))))
+	{
+		return n.desired;
+	}
+	++stats.measured;
+	// the children may get a different size or place even if this node does not
+	n.placed = false;
+
+	// the node never grows beyond its fixed size, its maximum or the space offered
+	auto bound = min(min(available, n.maxSize), n.size);
+	OptionalSize inner{shrink(bound.w, 2 * n.padding), shrink(bound.h, 2 * n.padding)};
+
+	auto content = n.contentSize;
+	auto fitted = true;
+	auto track = [&](Id child, OptionalSize offered)
+	{
+		auto s = measure(child, offered);
+		fitted = fitted and nodes[child].fitted;
+		return s;
+	};
+	switch (n.kind)
+	{
+		case Kind::Box:
+			for (auto child: n.children)
+			{
+				content = max(content, track(child, inner));
+			}
+			break;
+
+		case Kind::Stack:
+		{
+			// each child is offered what the ones before it left over
+			Size total{0, 0};
+			auto remaining = inner;
+			for (std::size_t i = 0; i < n.children.size(); ++i)
+			{
+				auto gap = i > 0 ? n.spacing : 0;
+				auto& main = mainAxis(remaining, n.direction);
+				main = shrink(main, gap);
+				auto s = track(n.children[i], remaining);
+				main = shrink(main, mainAxis(s, n.direction));
+				mainAxis(total, n.direction) += gap + mainAxis(s, n.direction);
+				crossAxis(total, n.direction) = std::max(crossAxis(total, n.direction), crossAxis(s, n.direction));
+			}
+			content = max(content, total);
+			break;
+		}
+
+		case Kind::Grid:
+		{
+			auto count = n.children.size();
+			auto columns = std::min<std::size_t>(static_cast<std::size_t>(n.columns), count);
+			auto rows = columns == 0 ? 0 : (count + columns - 1) / columns;
+			n.tracks.assign(columns + rows, 0);
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				auto s = track(n.children[i], inner);
+				auto& column = n.tracks[i % columns];
+				auto& row = n.tracks[columns + i / columns];
+				column = std::max(column, s.w);
+				row = std::max(row, s.h);
+			}
+
+			Size total{0, 0};
+			for (std::size_t c = 0; c < columns; ++c)
+			{
+				total.w += n.tracks[c] + (c > 0 ? n.spacing : 0);
+			}
+			for (std::size_t r = 0; r < rows; ++r)
+			{
+				total.h += n.tracks[columns + r] + (r > 0 ? n.spacing : 0);
+			}
+			content = max(content, total);
+			break;
+		}
+	}
+
+	auto desired = content + Vec2D{2 * n.padding, 2 * n.padding};
+	desired = {n.size.w.value_or(desired.w), n.size.h.value_or(desired.h)};
+	auto wanted = limit(max(desired, n.minSize), min(n.maxSize, n.size));
+	desired = limit(wanted, available);
+
+	n.desired = desired;
+	n.fitted = fitted and desired == wanted;
+	n.measuredFor = available;
+	n.measured = true;
+	return desired;
+}
+
+void Layout::arrange(Id id, Rect slot)
+{
+	auto& n = nodes[id];
+	auto size = n.stretch ? limit(slot.s, min(n.maxSize, n.size)) : min(n.desired, slot.s);
+	Rect local{slot.alignedPoint(n.align), size, n.align};
+
+	// the children depend only on the node's size and their own state
+	if (n.placed and not n.dirty and n.local.s == size)
+	{
+		n.local = local;
+		return;
+	}
+	n.local = local;
+	n.placed = true;
+	n.dirty = false;
+	++stats.relaid;
+
+	Rect content{{n.padding, n.padding}, {std::max(size.w - 2 * n.padding, 0), std::max(size.h - 2 * n.padding, 0)}};
+	switch (n.kind)
+	{
+		case Kind::Box:
+			for (auto child: n.children)
+			{
+				arrange(child, content);
+			}
+			break;
+
+		case Kind::Stack:
+		{
+			// space left along the main axis is shared by stretching children
+			auto d = n.direction;
+			auto used = 0;
+			auto stretching = 0;
+			for (std::size_t i = 0; i < n.children.size(); ++i)
+			{
+				auto const& child = nodes[n.children[i]];
+				auto desired = child.desired;
+				used += mainAxis(desired, d) + (i > 0 ? n.spacing : 0);
+				stretching += child.stretch;
+			}
+			auto extra = std::max(mainAxis(content.s, d) - used, 0);
+
+			auto cursor = content.p;
+			for (auto child: n.children)
+			{
+				auto cell = content.s;
+				auto desired = nodes[child].desired;
+				mainAxis(cell, d) = mainAxis(desired, d);
+				if (nodes[child].stretch)
+				{
+					auto share = extra / stretching + (extra % stretching > 0 ? 1 : 0);
+					mainAxis(cell, d) += share;
+					extra -= share;
+					--stretching;
+				}
+				arrange(child, {cursor, cell});
+				mainAxis(cursor, d) += mainAxis(cell, d) + n.spacing;
+			}
+			break;
+		}
+
+		case Kind::Grid:
+		{
+			auto columns = std::min<std::size_t>(static_cast<std::size_t>(n.columns), n.children.size());
+			auto y = content.p.y;
+			for (std::size_t i = 0; i < n.children.size(); i += columns)
+			{
+				auto x = content.p.x;
+				auto height = n.tracks[columns + i / columns];
+				for (std::size_t c = 0; c < columns and i + c < n.children.size(); ++c)
+				{
+					arrange(n.children[i + c], {{x, y}, {n.tracks[c], height}});
+					x += n.tracks[c] + n.spacing;
+				}
+				y += height + n.spacing;
+			}
+			break;
+		}
+	}
+}
+}
@@ -0,0 +1,387 @@
+#include "sdlpp/pixelops.h"
+
+#include <algorithm>
+#include <atomic>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SDLPP_PIXELOPS_X86 1
+#include <immintrin.h>
+#endif
+
+namespace SDL::PixelOps
+{
+namespace
+{
+constexpr std::uint32_t colorMask = 0x00FFFFFF;
+
+// exact round(x / 255) for x in [0, 255*255]
+constexpr std::uint32_t div255(std::uint32_t x) noexcept
+{
+	x += 128;
+	return (x + (x >> 8)) >> 8;
+}
+
+constexpr std::uint32_t channel(std::uint32_t p, int i) noexcept
+{
+	return (p >> (8 * i)) & 0xFF;
+}
+
+/* Scalar kernels */
+
+void fillScalar(std::uint32_t* dst, std::size_t n, std::uint32_t pixel) noexcept
+{
+	std::fill(dst, dst + n, pixel);
+}
+
+void blendFillScalar(std::uint32_t* dst, std::size_t n, std::uint32_t pixel) noexcept
+{
+	auto a = channel(pixel, 3);
+	for (std::size_t i = 0; i < n; ++i)
+	{
+		auto d = dst[i];
+		std::uint32_t out = 0;
+		for (int c = 0; c < 3; ++c)
+		{
+			out |= div255(channel(pixel, c) * a + channel(d, c) * (255 - a)) << (8 * c);
+		}
+		out |= div255(255 * a + channel(d, 3) * (255 - a)) << 24;
+		dst[i] = out;
+	}
+}
+
+void blitOverScalar(std::uint32_t* dst, std::uint32_t const* src, std::size_t n) noexcept
+{
+	for (std::size_t i = 0; i < n; ++i)
+	{
+		auto s = src[i];
+		auto d = dst[i];
+		auto inv = 255 - channel(s, 3);
+		std::uint32_t out = 0;
+		for (int c = 0; c < 4; ++c)
+		{
+			out |= std::min<std::uint32_t>(255, channel(s, c) + div255(channel(d, c) * inv)) << (8 * c);
+		}
+		dst[i] = out;
+	}
+}
+
+void blitColorKeyScalar(std::uint32_t* dst, std::uint32_t const* src, std::size_t n, std::uint32_t key) noexcept
+{
+	key &= colorMask;
+	for (std::size_t i = 0; i < n; ++i)
+	{
+		if ((src[i] & colorMask) != key)
+		{
+			dst[i] = src[i];
+		}
+	}
+}
+
+void swizzleScalar(std::uint32_t* dst, std::uint32_t const* src, std::size_t n) noexcept
+{
+	for (std::size_t i = 0; i < n; ++i)
+	{
+		auto p = src[i];
+		dst[i] = (p & 0xFF00FF00) | ((p & 0xFF) << 16) | ((p >> 16) & 0xFF);
+	}
+}
+
+#ifdef SDLPP_PIXELOPS_X86
+/* SSE2 kernels, 4 pixels per step */
+
+inline __m128i div255Sse2(__m128i x) noexcept
+{
+	x = _mm_add_epi16(x, _mm_set1_epi16(128));
+	return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+}
+
+void fillSse2(std::uint32_t* dst, std::size_t n, std::uint32_t pixel) noexcept
+{
+	auto v = _mm_set1_epi32(static_cast<int>(pixel));
+	std::size_t i = 0;
+	for (; i + 4 <= n; i += 4)
+	{
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), v);
+	}
+	fillScalar(dst + i, n - i, pixel);
+}
+
+void blendFillSse2(std::uint32_t* dst, std::size_t n, std::uint32_t pixel) noexcept
+{
+	auto a = static_cast<short>(channel(pixel, 3));
+	auto zero = _mm_setzero_si128();
+	// per-lane source term (alpha lane blends towards opaque) and inverse alpha
+	auto srcTerm = _mm_setr_epi16(
+		static_cast<short>(channel(pixel, 0) * a), static_cast<short>(channel(pixel, 1) * a),
+		static_cast<short>(channel(pixel, 2) * a), static_cast<short>(255 * a),
+		static_cast<short>(channel(pixel, 0) * a), static_cast<short>(channel(pixel, 1) * a),
+		static_cast<short>(channel(pixel, 2) * a), static_cast<short>(255 * a)
+	);
+	auto inv = _mm_set1_epi16(static_cast<short>(255 - a));
+
+	std::size_t i = 0;
+	for (; i + 4 <= n; i += 4)
+	{
+		auto d = _mm_loadu_si128(reinterpret_cast<__m128i const*>(dst + i));
+		auto lo = div255Sse2(_mm_add_epi16(srcTerm, _mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), inv)));
+		auto hi = div255Sse2(_mm_add_epi16(srcTerm, _mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), inv)));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(lo, hi));
+	}
+	blendFillScalar(dst + i, n - i, pixel);
+}
+
+inline __m128i blendOverSse2(__m128i s, __m128i d, __m128i zero, __m128i full) noexcept
+{
+	// broadcast each pixel's alpha (16-bit lane 3 of 4) to all of its lanes
+	auto sLo = _mm_unpacklo_epi8(s, zero);
+	auto sHi = _mm_unpackhi_epi8(s, zero);
+	auto invLo = _mm_sub_epi16(full, _mm_shufflehi_epi16(_mm_shufflelo_epi16(sLo, 0xFF), 0xFF));
+	auto invHi = _mm_sub_epi16(full, _mm_shufflehi_epi16(_mm_shufflelo_epi16(sHi, 0xFF), 0xFF));
+	auto lo = div255Sse2(_mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), invLo));
+	auto hi = div255Sse2(_mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), invHi));
+	return _mm_adds_epu8(s, _mm_packus_epi16(lo, hi));
+}
+
+void blitOverSse2(std::uint32_t* dst, std::uint32_t const* src, std::size_t n) noexcept
+{
+	auto zero = _mm_setzero_si128();
+	auto full = _mm_set1_epi16(255);
+	std::size_t i = 0;
+	for (; i + 4 <= n; i += 4)
+	{
+		auto s = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + i));
+		auto d = _mm_loadu_si128(reinterpret_cast<__m128i const*>(dst + i));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), blendOverSse2(s, d, zero, full));
+	}
+	blitOverScalar(dst + i, src + i, n - i);
+}
+
+void blitColorKeySse2(std::uint32_t* dst, std::uint32_t const* src, std::size_t n, std::uint32_t key) noexcept
+{
+	auto mask = _mm_set1_epi32(static_cast<int>(colorMask));
+	auto k = _mm_set1_epi32(static_cast<int>(key & colorMask));
+	std::size_t i = 0;
+	for (; i + 4 <= n; i += 4)
+	{
+		auto s = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + i));
+		auto d = _mm_loadu_si128(reinterpret_cast<__m128i const*>(dst + i));
+		auto keyed = _mm_cmpeq_epi32(_mm_and_si128(s, mask), k);
+		auto out = _mm_or_si128(_mm_and_si128(keyed, d), _mm_andnot_si128(keyed, s));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), out);
+	}
+	blitColorKeyScalar(dst + i, src + i, n - i, key);
+}
+
+void swizzleSse2(std::uint32_t* dst, std::uint32_t const* src, std::size_t n) noexcept
+{
+	auto keep = _mm_set1_epi32(static_cast<int>(0xFF00FF00));
+	auto low = _mm_set1_epi32(0xFF);
+	std::size_t i = 0;
+	for (; i + 4 <= n; i += 4)
+	{
+		auto p = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + i));
+		auto out = _mm_or_si128(
+			_mm_and_si128(p, keep),
+			_mm_or_si128(_mm_slli_epi32(_mm_and_si128(p, low), 16), _mm_and_si128(_mm_srli_epi32(p, 16), low))
+		);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), out);
+	}
+	swizzleScalar(dst + i, src + i, n - i);
+}
+
+/* AVX2 kernels, 8 pixels per step */
+
+#define SDLPP_AVX2 __attribute__((target("avx2")))
+
+SDLPP_AVX2 inline __m256i div255Avx2(__m256i x) noexcept
+{
+	x = _mm256_add_epi16(x, _mm256_set1_epi16(128));
+	return _mm256_srli_epi16(_mm256_add_epi16(x, _mm256_srli_epi16(x, 8)), 8);
+}
+
+SDLPP_AVX2 void fillAvx2(std::uint32_t* dst, std::size_t n, std::uint32_t pixel) noexcept
+{
+	auto v = _mm256_set1_epi32(static_cast<int>(pixel));
+	std::size_t i = 0;
+	for (; i + 8 <= n; i += 8)
+	{
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), v);
+	}
+	fillScalar(dst + i, n - i, pixel);
+}
+
+SDLPP_AVX2 void blendFillAvx2(std::uint32_t* dst, std::size_t n, std::uint32_t pixel) noexcept
+{
+	auto a = static_cast<short>(channel(pixel, 3));
+	auto zero = _mm256_setzero_si256();
+	auto r = static_cast<short>(channel(pixel, 0) * a);
+	auto g = static_cast<short>(channel(pixel, 1) * a);
+	auto b = static_cast<short>(channel(pixel, 2) * a);
+	auto al = static_cast<short>(255 * a);
+	auto srcTerm = _mm256_setr_epi16(r, g, b, al, r, g, b, al, r, g, b, al, r, g, b, al);
+	auto inv = _mm256_set1_epi16(static_cast<short>(255 - a));
+
+	std::size_t i = 0;
+	for (; i + 8 <= n; i += 8)
+	{
+		auto d = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(dst + i));
+		auto lo = div255Avx2(_mm256_add_epi16(srcTerm, _mm256_mullo_epi16(_mm256_unpacklo_epi8(d, zero), inv)));
+		auto hi = div255Avx2(_mm256_add_epi16(srcTerm, _mm256_mullo_epi16(_mm256_unpackhi_epi8(d, zero), inv)));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_packus_epi16(lo, hi));
+	}
+	blendFillSse2(dst + i, n - i, pixel);
+}
+
+SDLPP_AVX2 void blitOverAvx2(std::uint32_t* dst, std::uint32_t const* src, std::size_t n) noexcept
+{
+	auto zero = _mm256_setzero_si256();
+	auto full = _mm256_set1_epi16(255);
+	std::size_t i = 0;
+	for (; i + 8 <= n; i += 8)
+	{
+		auto s = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(src + i));
+		auto d = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(dst + i));
+		auto sLo = _mm256_unpacklo_epi8(s, zero);
+		auto sHi = _mm256_unpackhi_epi8(s, zero);
+		auto invLo = _mm256_sub_epi16(full, _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(sLo, 0xFF), 0xFF));
+		auto invHi = _mm256_sub_epi16(full, _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(sHi, 0xFF), 0xFF));
+		auto lo = div255Avx2(_mm256_mullo_epi16(_mm256_unpacklo_epi8(d, zero), invLo));
+		auto hi = div255Avx2(_mm256_mullo_epi16(_mm256_unpackhi_epi8(d, zero), invHi));
+		auto out = _mm256_adds_epu8(s, _mm256_packus_epi16(lo, hi));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), out);
+	}
+	blitOverSse2(dst + i, src + i, n - i);
+}
+
+SDLPP_AVX2 void blitColorKeyAvx2(std::uint32_t* dst, std::uint32_t const* src, std::size_t n, std::uint32_t key) noexcept
+{
+	auto mask = _mm256_set1_epi32(static_cast<int>(colorMask));
+	auto k = _mm256_set1_epi32(static_cast<int>(key & colorMask));
+	std::size_t i = 0;
+	for (; i + 8 <= n; i += 8)
+	{
+		auto s = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(src + i));
+		auto d = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(dst + i));
+		auto keyed = _mm256_cmpeq_epi32(_mm256_and_si256(s, mask), k);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_blendv_epi8(s, d, keyed));
+	}
+	blitColorKeySse2(dst + i, src + i, n - i, key);
+}
+
+SDLPP_AVX2 void swizzleAvx2(std::uint32_t* dst, std::uint32_t const* src, std::size_t n) noexcept
+{
+	auto shuffle = _mm256_setr_epi8(
+		2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15,
+		2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15
+	);
+	std::size_t i = 0;
+	for (; i + 8 <= n; i += 8)
+	{
+		auto p = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(src + i));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_shuffle_epi8(p, shuffle));
+	}
+	swizzleSse2(dst + i, src + i, n - i);
+}
+
+#undef SDLPP_AVX2
+#endif
+
+struct Kernels
+{
+	void (*fill)(std::uint32_t*, std::size_t, std::uint32_t) noexcept;
+	void (*blendFill)(std::uint32_t*, std::size_t, std::uint32_t) noexcept;
+	void (*blitOver)(std::uint32_t*, std::uint32_t const*, std::size_t) noexcept;
+	void (*blitColorKey)(std::uint32_t*, std::uint32_t const*, std::size_t, std::uint32_t) noexcept;
+	void (*swizzle)(std::uint32_t*, std::uint32_t const*, std::size_t) noexcept;
+};
+
+constexpr Kernels scalarKernels{fillScalar, blendFillScalar, blitOverScalar, blitColorKeyScalar, swizzleScalar};
+#ifdef SDLPP_PIXELOPS_X86
+constexpr Kernels sse2Kernels{fillSse2, blendFillSse2, blitOverSse2, blitColorKeySse2, swizzleSse2};
+constexpr Kernels avx2Kernels{fillAvx2, blendFillAvx2, blitOverAvx2, blitColorKeyAvx2, swizzleAvx2};
+#endif
+
+Isa detectIsa() noexcept
+{
+#ifdef SDLPP_PIXELOPS_X86
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2"))
+	{
+		return Isa::AVX2;
+	}
+	if (__builtin_cpu_supports("sse2"))
+	{
+		return Isa::SSE2;
+	}
+#endif
+	return Isa::Scalar;
+}
+
+Kernels const& kernelsFor(Isa isa) noexcept
+{
+	switch (isa)
+	{
+#ifdef SDLPP_PIXELOPS_X86
+		case Isa::AVX2:
+			return avx2Kernels;
+		case Isa::SSE2:
+			return sse2Kernels;
+#endif
+		default:
+			return scalarKernels;
+	}
+}
+
+std::atomic<Isa>& selectedIsa() noexcept
+{
+	static std::atomic<Isa> isa{detectIsa()};
+	return isa;
+}
+
+Kernels const& active() noexcept
+{
+	return kernelsFor(selectedIsa().load(std::memory_order_relaxed));
+}
+}
+
+Isa supportedIsa() noexcept
+{
+	static Isa const isa = detectIsa();
+	return isa;
+}
+
+Isa activeIsa() noexcept
+{
+	return selectedIsa().load(std::memory_order_relaxed);
+}
+
+void setIsa(Isa isa) noexcept
+{
+	selectedIsa().store(std::min(isa, supportedIsa()), std::memory_order_relaxed);
+}
+
+void fill(std::span<std::uint32_t> dst, std::uint32_t pixel) noexcept
+{
+	active().fill(dst.data(), dst.size(), pixel);
+}
+
+void blendFill(std::span<std::uint32_t> dst, std::uint32_t pixel) noexcept
+{
+	active().blendFill(dst.data(), dst.size(), pixel);
+}
+
+void blitOver(std::span<std::uint32_t> dst, std::span<std::uint32_t const> src) noexcept
+{
+	active().blitOver(dst.data(), src.data(), std::min(dst.size(), src.size()));
+}
+
+void blitColorKey(std::span<std::uint32_t> dst, std::span<std::uint32_t const> src, std::uint32_t key) noexcept
+{
+	active().blitColorKey(dst.data(), src.data(), std::min(dst.size(), src.size()), key);
+}
+
+void swizzleRedBlue(std::span<std::uint32_t> dst, std::span<std::uint32_t const> src) noexcept
+{
+	active().swizzle(dst.data(), src.data(), std::min(dst.size(), src.size()));
+}
+}
@@ -0,0 +1,260 @@
+#include "sdlpp/profiler.h"
+
+#include <atomic>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+#include "sdlpp/error.h"
+
+namespace SDL::Profiler
+{
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+struct TraceEvent
+{
+	char const* name;
+	std::uint32_t thread;
+	Clock::time_point start;
+	Clock::duration duration;
+};
+
+struct TraceFrame
+{
+	Clock::time_point end;
+	FrameStats stats;
+};
+
+std::array<std::atomic<std::uint64_t>, counterCount> current{};
+std::atomic<bool> tracing{false};
+
+std::mutex mutex;
+FrameStats last;
+FrameStats sum;
+Clock::time_point lastPresent = Clock::now();
+
+Clock::time_point traceStart;
+std::vector<TraceEvent> traceEvents;
+std::vector<TraceFrame> traceFrames;
+
+std::uint32_t threadIndex() noexcept
+{
+	static std::atomic<std::uint32_t> next{0};
+	thread_local std::uint32_t const index = next.fetch_add(1, std::memory_order_relaxed);
+	return index;
+}
+
+void writeEscaped(std::ostream& out, std::string_view s)
+{
+	for (auto c: s)
+	{
+		if (c == '"' or c == '\\')
+		{
+			out << '\\';
+		}
+		out << c;
+	}
+}
+
+double micros(Clock::duration d)
+{
+	return std::chrono::duration<double, std::micro>(d).count();
+}
+}
+
+char const* getName(Counter c) noexcept
+{
+	switch (c)
+	{
+		case Counter::DrawCalls: return "draw calls";
+		case Counter::TextureCreations: return "texture creations";
+		case Counter::TextureUploads: return "texture uploads";
+		case Counter::TextureDestructions: return "texture destructions";
+		case Counter::FontRasterizations: return "font rasterizations";
+		case Counter::EventsPumped: return "events pumped";
+	}
+	return "unknown";
+}
+
+void count(Counter c, std::uint64_t n) noexcept
+{
+	current[static_cast<std::size_t>(c)].fetch_add(n, std::memory_order_relaxed);
+}
+
+void endFrame(std::chrono::nanoseconds presentTime) noexcept
+{
+	auto now = Clock::now();
+
+	std::unique_lock hold{mutex};
+	FrameStats f;
+	f.frame = sum.frame;
+	for (std::size_t i = 0; i < counterCount; ++i)
+	{
+		f.counters[i] = current[i].exchange(0, std::memory_order_relaxed);
+		sum.counters[i] += f.counters[i];
+	}
+	f.presentTime = presentTime;
+	f.frameTime = now - lastPresent;
+	lastPresent = now;
+
+	++sum.frame;
+	sum.presentTime += f.presentTime;
+	sum.frameTime += f.frameTime;
+	last = f;
+
+	if (tracing.load(std::memory_order_relaxed))
+	{
+		try
+		{
+			traceFrames.push_back({now, f});
+		}
+		catch (...)
+		{
+			// dropping a sample is preferable to failing the frame
+		}
+	}
+}
+
+FrameStats lastFrame() noexcept
+{
+	std::unique_lock hold{mutex};
+	return last;
+}
+
+FrameStats totals() noexcept
+{
+	std::unique_lock hold{mutex};
+	return sum;
+}
+
+void reset() noexcept
+{
+	std::unique_lock hold{mutex};
+	for (auto& c: current)
+	{
+		c.store(0, std::memory_order_relaxed);
+	}
+	last = {};
+	sum = {};
+	lastPresent = Clock::now();
+}
+
+PresentScope::PresentScope() noexcept
+	: start{Clock::now()}
+{}
+
+PresentScope::~PresentScope() noexcept
+{
+	endFrame(Clock::now() - start);
+}
+
+Zone::Zone(char const* name_) noexcept
+	: name{name_}
+	, start{Clock::now()}
+	, active{tracing.load(std::memory_order_relaxed)}
+{}
+
+Zone::~Zone() noexcept
+{
+	if (not active)
+	{
+		return;
+	}
+	auto duration = Clock::now() - start;
+
+	std::unique_lock hold{mutex};
+	if (not tracing.load(std::memory_order_relaxed))
+	{
+		return;
+	}
+	try
+	{
+		traceEvents.push_back({name, threadIndex(), start, duration});
+	}
+	catch (...)
+	{
+	}
+}
+
+void startTrace()
+{
+	std::unique_lock hold{mutex};
+	traceEvents.clear();
+	traceFrames.clear();
+	traceEvents.reserve(1 << 16);
+	traceStart = Clock::now();
+	tracing.store(true, std::memory_order_relaxed);
+}
+
+void stopTrace() noexcept
+{
+	tracing.store(false, std::memory_order_relaxed);
+}
+
+bool isTracing() noexcept
+{
+	return tracing.load(std::memory_order_relaxed);
+}
+
+void writeTrace(std::filesystem::path const& fname)
+{
+	std::ofstream out{fname};
+	if (not out)
+	{
+		throw Error{"Failed to open trace file " + fname.string()};
+	}
+
+	// microseconds to the nanosecond, the default 6 significant digits would
+	// round timestamps to 10 us after a second of tracing
+	out << std::fixed << std::setprecision(3);
+
+	std::unique_lock hold{mutex};
+	out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+	auto first = true;
+	auto separator = [&out, &first]
+	{
+		if (not first)
+		{
+			out << ",\n";
+		}
+		first = false;
+	};
+
+	for (auto const& e: traceEvents)
+	{
+		separator();
+		out << "{\"name\":\"";
+		writeEscaped(out, e.name);
+		out << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << e.thread
+			<< ",\"ts\":" << micros(e.start - traceStart)
+			<< ",\"dur\":" << micros(e.duration) << '}';
+	}
+
+	for (auto const& f: traceFrames)
+	{
+		auto ts = micros(f.end - traceStart);
+		separator();
+		out << "{\"name\":\"sdlpp\",\"ph\":\"C\",\"pid\":1,\"ts\":" << ts << ",\"args\":{";
+		for (std::size_t i = 0; i < counterCount; ++i)
+		{
+			out << (i == 0 ? "" : ",") << '"' << getName(static_cast<Counter>(i)) << "\":" << f.stats.counters[i];
+		}
+		out << "}}";
+
+		separator();
+		out << "{\"name\":\"frame\",\"ph\":\"C\",\"pid\":1,\"ts\":" << ts
+			<< ",\"args\":{\"present ms\":" << micros(f.stats.presentTime) / 1000
+			<< ",\"frame ms\":" << micros(f.stats.frameTime) / 1000 << "}}";
+	}
+	out << "]}\n";
+
+	if (not out)
+	{
+		throw Error{"Failed to write trace file " + fname.string()};
+	}
+}
+}
@@ -0,0 +1,108 @@
+#include "sdlpp/rendertarget.h"
+
+#include <utility>
+
+#include "sdlpp/error.h"
+#include "sdlpp/pixel.h"
+#include "sdlpp/profiler.h"
+#include "sdlpp/video.h"
+
+namespace SDL
+{
+RenderTarget::RenderTarget(Renderer& renderer, Size size_, SDL_BlendMode mode)
+	: texture{SDL_CreateTexture(renderer.get(), SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, size_.w, size_.h)}
+	, alive{renderer.getLifetime()}
+	, size{size_}
+{
+	if (texture == nullptr)
+	{
+		throw Error{SDL_GetError()};
+	}
+	SDLPP_PROFILE_COUNT(TextureCreations, 1);
+
+	if (SDL_SetTextureBlendMode(texture, mode) < 0)
+	{
+		release();
+		throw Error{SDL_GetError()};
+	}
+
+	// the initial contents of a target texture are undefined
+	try
+	{
+		TargetScope scope{renderer, *this};
+		renderer.clear(Color{0, 0, 0, 0});
+	}
+	catch (...)
+	{
+		release();
+		throw;
+	}
+}
+
+RenderTarget::RenderTarget(RenderTarget&& other) noexcept
+	: texture{std::exchange(other.texture, nullptr)}
+	, alive{std::move(other.alive)}
+	, size{other.size}
+{}
+
+RenderTarget& RenderTarget::operator=(RenderTarget&& other) noexcept
+{
+	if (this != &other)
+	{
+		release();
+		texture = std::exchange(other.texture, nullptr);
+		alive = std::move(other.alive);
+		size = other.size;
+	}
+	return *this;
+}
+
+RenderTarget::~RenderTarget() noexcept
+{
+	release();
+}
+
+void RenderTarget::release() noexcept
+{
+	if (texture != nullptr and not alive.expired())
+	{
+		SDL_DestroyTexture(texture);
+		SDLPP_PROFILE_COUNT(TextureDestructions, 1);
+	}
+	texture = nullptr;
+}
+
+Size RenderTarget::getSize() const noexcept
+{
+	return size;
+}
+
+SDL_Texture* RenderTarget::get() const noexcept
+{
+	return texture;
+}
+
+TargetScope::TargetScope(Renderer& renderer_, RenderTarget& target)
+	: renderer{renderer_}
+	, previous{SDL_GetRenderTarget(renderer_.get())}
+{
+	renderer.flush();
+	if (SDL_SetRenderTarget(renderer.get(), target.get()) < 0)
+	{
+		throw Error{SDL_GetError()};
+	}
+}
+
+TargetScope::~TargetScope() noexcept
+{
+	try
+	{
+		renderer.flush();
+	}
+	catch (Error const&)
+	{
+		// nothing sensible to do here, see the class comment
+	}
+	SDL_SetRenderTarget(renderer.get(), previous);
+}
+}
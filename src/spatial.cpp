@@ -0,0 +1,412 @@
+#include "sdlpp/spatial.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "sdlpp/error.h"
+
+namespace SDL
+{
+namespace
+{
+void erase(std::vector<RectStore::Id>& list, RectStore::Id id) noexcept
+{
+	auto it = std::find(list.begin(), list.end(), id);
+	if (it != list.end())
+	{
+		*it = list.back();
+		list.pop_back();
+	}
+}
+}
+
+RectStore::Id RectStore::add(Rect r)
+{
+	Id id;
+	if (not freeIds.empty())
+	{
+		id = freeIds.back();
+		freeIds.pop_back();
+	}
+	else
+	{
+		id = static_cast<Id>(x.size());
+		x.push_back(0);
+		y.push_back(0);
+		w.push_back(0);
+		h.push_back(0);
+		stamps.push_back(0);
+		live.push_back(false);
+	}
+	live[id] = true;
+	set(id, r);
+	return id;
+}
+
+void RectStore::remove(Id id) noexcept
+{
+	// an empty rect matches no query
+	set(id, {{0, 0}, {0, 0}});
+	live[id] = false;
+	freeIds.push_back(id);
+}
+
+bool RectStore::exists(Id id) const noexcept
+{
+	return id < live.size() and live[id];
+}
+
+void RectStore::set(Id id, Rect r) noexcept
+{
+	x[id] = r.p.x;
+	y[id] = r.p.y;
+	w[id] = r.s.w;
+	h[id] = r.s.h;
+}
+
+Rect RectStore::get(Id id) const noexcept
+{
+	return {{x[id], y[id]}, {w[id], h[id]}};
+}
+
+bool RectStore::contains(Id id, Point p) const noexcept
+{
+	auto dx = p.x - x[id];
+	auto dy = p.y - y[id];
+	return dx >= 0 and dx < w[id] and dy >= 0 and dy < h[id];
+}
+
+bool RectStore::intersects(Id id, Rect r) const noexcept
+{
+	return x[id] < r.p.x + r.s.w and r.p.x < x[id] + w[id]
+		and y[id] < r.p.y + r.s.h and r.p.y < y[id] + h[id]
+		and w[id] > 0 and h[id] > 0 and r.s.w > 0 and r.s.h > 0;
+}
+
+std::size_t RectStore::size() const noexcept
+{
+	return x.size() - freeIds.size();
+}
+
+void RectStore::beginQuery() const noexcept
+{
+	if (++stamp == 0)
+	{
+		std::fill(stamps.begin(), stamps.end(), 0);
+		stamp = 1;
+	}
+}
+
+bool RectStore::firstVisit(Id id) const noexcept
+{
+	if (stamps[id] == stamp)
+	{
+		return false;
+	}
+	stamps[id] = stamp;
+	return true;
+}
+
+SpatialGrid::SpatialGrid(Rect bounds_, Size cellSize_)
+	: bounds{bounds_}
+	, cellSize{cellSize_}
+{
+	if (bounds.s.w <= 0 or bounds.s.h <= 0 or cellSize.w <= 0 or cellSize.h <= 0)
+	{
+		throw Error{"Invalid spatial grid geometry"};
+	}
+	cellCount = {(bounds.s.w + cellSize.w - 1) / cellSize.w, (bounds.s.h + cellSize.h - 1) / cellSize.h};
+	cells.resize(static_cast<std::size_t>(cellCount.w) * static_cast<std::size_t>(cellCount.h));
+}
+
+SpatialGrid::Id SpatialGrid::insert(Rect r)
+{
+	auto id = rects.add(r);
+	link(id, r);
+	return id;
+}
+
+void SpatialGrid::remove(Id id)
+{
+	if (not rects.exists(id))
+	{
+		return;
+	}
+	unlink(id, rects.get(id));
+	rects.remove(id);
+}
+
+void SpatialGrid::move(Id id, Rect r)
+{
+	auto old = rects.get(id);
+	auto before = cellsOf(old);
+	auto after = cellsOf(r);
+	if (before.x0 != after.x0 or before.y0 != after.y0 or before.x1 != after.x1 or before.y1 != after.y1)
+	{
+		unlink(id, old);
+		link(id, r);
+	}
+	rects.set(id, r);
+}
+
+Rect SpatialGrid::get(Id id) const noexcept
+{
+	return rects.get(id);
+}
+
+std::size_t SpatialGrid::size() const noexcept
+{
+	return rects.size();
+}
+
+std::size_t SpatialGrid::query(Point p, std::vector<Id>& out) const
+{
+	auto range = cellsOf({p, {1, 1}});
+	std::size_t found = 0;
+	for (auto id: cell(range.x0, range.y0))
+	{
+		if (rects.contains(id, p))
+		{
+			out.push_back(id);
+			++found;
+		}
+	}
+	return found;
+}
+
+std::size_t SpatialGrid::query(Rect r, std::vector<Id>& out) const
+{
+	auto range = cellsOf(r);
+	auto single = range.x0 == range.x1 and range.y0 == range.y1;
+	rects.beginQuery();
+
+	std::size_t found = 0;
+	for (int cy = range.y0; cy <= range.y1; ++cy)
+	{
+		for (int cx = range.x0; cx <= range.x1; ++cx)
+		{
+			for (auto id: cell(cx, cy))
+			{
+				if (rects.intersects(id, r) and (single or rects.firstVisit(id)))
+				{
+					out.push_back(id);
+					++found;
+				}
+			}
+		}
+	}
+	return found;
+}
+
+SpatialGrid::CellRange SpatialGrid::cellsOf(Rect r) const noexcept
+{
+	auto toCell = [](int v, int origin, int size, int count)
+	{
+		return std::clamp((v - origin) / size - (v < origin ? 1 : 0), 0, count - 1);
+	};
+	return {
+		toCell(r.p.x, bounds.p.x, cellSize.w, cellCount.w),
+		toCell(r.p.y, bounds.p.y, cellSize.h, cellCount.h),
+		toCell(r.p.x + std::max(r.s.w, 1) - 1, bounds.p.x, cellSize.w, cellCount.w),
+		toCell(r.p.y + std::max(r.s.h, 1) - 1, bounds.p.y, cellSize.h, cellCount.h),
+	};
+}
+
+std::vector<SpatialGrid::Id>& SpatialGrid::cell(int cx, int cy) noexcept
+{
+	return cells[static_cast<std::size_t>(cy * cellCount.w + cx)];
+}
+
+std::vector<SpatialGrid::Id> const& SpatialGrid::cell(int cx, int cy) const noexcept
+{
+	return cells[static_cast<std::size_t>(cy * cellCount.w + cx)];
+}
+
+void SpatialGrid::link(Id id, Rect r)
+{
+	auto range = cellsOf(r);
+	for (int cy = range.y0; cy <= range.y1; ++cy)
+	{
+		for (int cx = range.x0; cx <= range.x1; ++cx)
+		{
+			cell(cx, cy).push_back(id);
+		}
+	}
+}
+
+void SpatialGrid::unlink(Id id, Rect r) noexcept
+{
+	auto range = cellsOf(r);
+	for (int cy = range.y0; cy <= range.y1; ++cy)
+	{
+		for (int cx = range.x0; cx <= range.x1; ++cx)
+		{
+			erase(cell(cx, cy), id);
+		}
+	}
+}
+
+LooseQuadtree::LooseQuadtree(Rect bounds_, int maxDepth_)
+	: bounds{bounds_}
+	, maxDepth{maxDepth_}
+{
+	if (bounds.s.w <= 0 or bounds.s.h <= 0 or maxDepth < 0 or maxDepth > 10)
+	{
+		throw Error{"Invalid quadtree geometry"};
+	}
+	// no point in cells smaller than a pixel
+	while (maxDepth > 0 and (bounds.s.w >> maxDepth == 0 or bounds.s.h >> maxDepth == 0))
+	{
+		--maxDepth;
+	}
+
+	levels.resize(static_cast<std::size_t>(maxDepth) + 1);
+	levelCounts.resize(levels.size());
+}
+
+LooseQuadtree::Id LooseQuadtree::insert(Rect r)
+{
+	auto id = rects.add(r);
+	if (locations.size() <= id)
+	{
+		locations.resize(id + 1);
+	}
+	auto l = locate(r);
+	items(l).push_back(id);
+	++levelCounts[static_cast<std::size_t>(l.level)];
+	locations[id] = l;
+	return id;
+}
+
+void LooseQuadtree::remove(Id id)
+{
+	if (not rects.exists(id))
+	{
+		return;
+	}
+	auto l = locations[id];
+	erase(items(l), id);
+	--levelCounts[static_cast<std::size_t>(l.level)];
+	rects.remove(id);
+}
+
+void LooseQuadtree::move(Id id, Rect r)
+{
+	auto before = locations[id];
+	auto after = locate(r);
+	if (before.level != after.level or before.node != after.node)
+	{
+		erase(items(before), id);
+		--levelCounts[static_cast<std::size_t>(before.level)];
+		items(after).push_back(id);
+		++levelCounts[static_cast<std::size_t>(after.level)];
+		locations[id] = after;
+	}
+	rects.set(id, r);
+}
+
+Rect LooseQuadtree::get(Id id) const noexcept
+{
+	return rects.get(id);
+}
+
+std::size_t LooseQuadtree::size() const noexcept
+{
+	return rects.size();
+}
+
+std::size_t LooseQuadtree::query(Point p, std::vector<Id>& out) const
+{
+	return collect({p, {1, 1}}, out, [this, p](Id id)
+	{
+		return rects.contains(id, p);
+	});
+}
+
+std::size_t LooseQuadtree::query(Rect r, std::vector<Id>& out) const
+{
+	return collect(r, out, [this, r](Id id)
+	{
+		return rects.intersects(id, r);
+	});
+}
+
+LooseQuadtree::Location LooseQuadtree::locate(Rect r) const noexcept
+{
+	auto w = static_cast<std::int64_t>(std::max(r.s.w, 1));
+	auto h = static_cast<std::int64_t>(std::max(r.s.h, 1));
+
+	// the deepest level whose cells are at least as large as the rect
+	int level = 0;
+	while (level < maxDepth
+		and (w << (level + 1)) <= bounds.s.w
+		and (h << (level + 1)) <= bounds.s.h)
+	{
+		++level;
+	}
+
+	auto n = std::int64_t{1} << level;
+	auto cell = [n](std::int64_t centre, int origin, int size)
+	{
+		auto c = (centre - origin) * n;
+		auto i = c < 0 ? -1 : c / size;
+		return std::clamp<std::int64_t>(i, 0, n - 1);
+	};
+	auto cx = cell(r.p.x + r.s.w / 2, bounds.p.x, bounds.s.w);
+	auto cy = cell(r.p.y + r.s.h / 2, bounds.p.y, bounds.s.h);
+	return {level, static_cast<std::size_t>(cy * n + cx)};
+}
+
+std::vector<LooseQuadtree::Id>& LooseQuadtree::items(Location l)
+{
+	auto& nodes = levels[static_cast<std::size_t>(l.level)];
+	if (nodes.empty())
+	{
+		nodes.resize(std::size_t{1} << (2 * l.level));
+	}
+	return nodes[l.node];
+}
+
+template<typename Test>
+std::size_t LooseQuadtree::collect(Rect area, std::vector<Id>& out, Test test) const
+{
+	std::size_t found = 0;
+	for (int level = 0; level <= maxDepth; ++level)
+	{
+		if (levelCounts[static_cast<std::size_t>(level)] == 0)
+		{
+			continue;
+		}
+
+		// nodes whose loose reach (half a cell beyond the cell) touches the area
+		auto n = 1 << level;
+		auto cellW = static_cast<double>(bounds.s.w) / n;
+		auto cellH = static_cast<double>(bounds.s.h) / n;
+		auto range = [n](double lo, double hi, double cellSize)
+		{
+			auto a = static_cast<int>(std::floor((lo - cellSize / 2) / cellSize));
+			auto b = static_cast<int>(std::floor((hi + cellSize / 2) / cellSize));
+			return std::pair{std::clamp(a, 0, n - 1), std::clamp(b, 0, n - 1)};
+		};
+		auto [x0, x1] = range(area.p.x - bounds.p.x, area.p.x + area.s.w - bounds.p.x, cellW);
+		auto [y0, y1] = range(area.p.y - bounds.p.y, area.p.y + area.s.h - bounds.p.y, cellH);
+
+		auto const& nodes = levels[static_cast<std::size_t>(level)];
+		for (int cy = y0; cy <= y1; ++cy)
+		{
+			for (int cx = x0; cx <= x1; ++cx)
+			{
+				for (auto id: nodes[static_cast<std::size_t>(cy * n + cx)])
+				{
+					if (test(id))
+					{
+						out.push_back(id);
+						++found;
+					}
+				}
+			}
+		}
+	}
+	return found;
+}
+}
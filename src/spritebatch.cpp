@@ -0,0 +1,159 @@
+#include "sdlpp/spritebatch.h"
+
+#include <cmath>
+#include <numbers>
+
+#include "sdlpp/atlas.h"
+#include "sdlpp/error.h"
+#include "sdlpp/profiler.h"
+#include "sdlpp/rendertarget.h"
+#include "sdlpp/surface.h"
+#include "sdlpp/video.h"
+
+namespace SDL
+{
+SpriteBatch::SpriteBatch(Renderer& renderer_)
+	: renderer{renderer_}
+{}
+
+void SpriteBatch::draw(Surface const& s, Sprite const& sprite)
+{
+	auto size = s.getSize();
+	if (size.w * size.h == 0)
+	{
+		return;
+	}
+	draw(s.getTexture(renderer), {{0, 0}, size}, sprite);
+}
+
+void SpriteBatch::draw(AtlasHandle h, Sprite const& sprite)
+{
+	if (not h.atlas->contains(h))
+	{
+		return;
+	}
+	draw(h.atlas->getTexture(h), h.atlas->getRect(h), sprite);
+}
+
+void SpriteBatch::draw(RenderTarget const& t, Sprite const& sprite)
+{
+	draw(t.get(), {{0, 0}, t.getSize()}, sprite);
+}
+
+void SpriteBatch::draw(SDL_Texture* texture_, Rect src, Sprite const& sprite)
+{
+	SDL_Color c = sprite.tint;
+	setTexture(texture_);
+	push(src, sprite, {c, c, c, c});
+}
+
+void SpriteBatch::draw(SDL_Texture* texture_, Rect src, Sprite const& sprite, std::array<Color, 4> const& corners)
+{
+	setTexture(texture_);
+	push(src, sprite, {corners[0], corners[1], corners[2], corners[3]});
+}
+
+void SpriteBatch::flush()
+{
+	submit();
+	texture = nullptr;  // the texture may be destroyed before the next frame
+}
+
+void SpriteBatch::submit()
+{
+	if (vertices.empty())
+	{
+		return;
+	}
+	renderer.flush();
+
+	auto quads = vertices.size() / 4;
+	SDLPP_PROFILE_COUNT(DrawCalls, 1);
+	auto result = SDL_RenderGeometry(
+		renderer.get(), texture,
+		vertices.data(), static_cast<int>(vertices.size()),
+		indices.data(), static_cast<int>(quads * 6)
+	);
+	vertices.clear();
+	if (result < 0)
+	{
+		throw Error{SDL_GetError()};
+	}
+}
+
+std::size_t SpriteBatch::pending() const noexcept
+{
+	return vertices.size() / 4;
+}
+
+void SpriteBatch::setTexture(SDL_Texture* texture_)
+{
+	if (texture_ == texture)
+	{
+		return;
+	}
+	submit();
+
+	int w, h;
+	if (SDL_QueryTexture(texture_, nullptr, nullptr, &w, &h) < 0)
+	{
+		throw Error{SDL_GetError()};
+	}
+	texture = texture_;
+	invWidth = 1.0f / static_cast<float>(w);
+	invHeight = 1.0f / static_cast<float>(h);
+}
+
+void SpriteBatch::push(Rect src, Sprite const& sprite, std::array<SDL_Color, 4> const& colors)
+{
+	if (vertices.size() / 4 == maxQuads)
+	{
+		submit();
+	}
+
+	auto quad = vertices.size() / 4;
+	if (indices.size() < (quad + 1) * 6)
+	{
+		auto base = static_cast<int>(quad * 4);
+		for (auto i: {0, 1, 2, 0, 2, 3})
+		{
+			indices.push_back(base + i);
+		}
+	}
+
+	// corners relative to the pivot, scaled
+	auto w = static_cast<float>(src.s.w) * sprite.scale.x;
+	auto h = static_cast<float>(src.s.h) * sprite.scale.y;
+	auto x0 = -sprite.pivot.x * w;
+	auto y0 = -sprite.pivot.y * h;
+	auto x1 = x0 + w;
+	auto y1 = y0 + h;
+	std::array<SDL_FPoint, 4> corners{{{x0, y0}, {x1, y0}, {x1, y1}, {x0, y1}}};
+
+	if (sprite.rotation != 0)
+	{
+		auto radians = sprite.rotation * std::numbers::pi_v<float> / 180;
+		auto c = std::cos(radians);
+		auto s = std::sin(radians);
+		for (auto& p: corners)
+		{
+			p = {p.x * c - p.y * s, p.x * s + p.y * c};
+		}
+	}
+
+	auto u0 = static_cast<float>(src.p.x) * invWidth;
+	auto v0 = static_cast<float>(src.p.y) * invHeight;
+	auto u1 = static_cast<float>(src.p.x + src.s.w) * invWidth;
+	auto v1 = static_cast<float>(src.p.y + src.s.h) * invHeight;
+	std::array<SDL_FPoint, 4> const uv{{{u0, v0}, {u1, v0}, {u1, v1}, {u0, v1}}};
+
+	for (std::size_t i = 0; i < 4; ++i)
+	{
+		vertices.push_back({
+			{corners[i].x + sprite.position.x, corners[i].y + sprite.position.y},
+			colors[i],
+			uv[i],
+		});
+	}
+}
+}
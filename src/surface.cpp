@@ -1,11 +1,18 @@
 #include "sdlpp/surface.h"
 
+#include <algorithm>
 #include <cmath>
 #include <array>
+#include <cstring>
+#include <span>
 
+#include "sdlpp/archive.h"
 #include "sdlpp/error.h"
 #include "sdlpp/video.h"
 #include "sdlpp/pixel.h"
+#include "sdlpp/pixelops.h"
+#include "sdlpp/profiler.h"
+#include "sdlpp/surfacepool.h"
 
 namespace SDL
 {
@@ -31,6 +38,84 @@ SDL_Surface* createSurface(SDL::Size size)
 	return s;
 }
 
+namespace
+{
+bool hasPixelOpsLayout(SDL_Surface const* s) noexcept
+{
+	return s->format->BytesPerPixel == 4 and s->format->Amask == 0xff000000;
+}
+
+std::span<std::uint32_t> pixelRow(SDL_Surface* s, int y, int x, int w) noexcept
+{
+	auto row = reinterpret_cast<std::uint32_t*>(static_cast<std::uint8_t*>(s->pixels) + y * s->pitch);
+	return {row + x, static_cast<std::size_t>(w)};
+}
+
+// intersection of r with the surface clip rectangle, empty if they do not overlap
+SDL_Rect clip(SDL_Surface const* s, SDL_Rect r) noexcept
+{
+	auto const& c = s->clip_rect;
+	auto x0 = std::max(r.x, c.x);
+	auto y0 = std::max(r.y, c.y);
+	auto x1 = std::min(r.x + r.w, c.x + c.w);
+	auto y1 = std::min(r.y + r.h, c.y + c.h);
+	return {x0, y0, std::max(0, x1 - x0), std::max(0, y1 - y0)};
+}
+
+class SurfaceLock
+{
+	public:
+		SurfaceLock(SDL_Surface* s_)
+			: s{SDL_MUSTLOCK(s_) ? s_ : nullptr}
+		{
+			if (s != nullptr and SDL_LockSurface(s) < 0)
+			{
+				throw Error{SDL_GetError()};
+			}
+		}
+
+		~SurfaceLock() noexcept
+		{
+			if (s != nullptr)
+			{
+				SDL_UnlockSurface(s);
+			}
+		}
+
+	private:
+		SDL_Surface* s;
+};
+
+void requirePixelOpsLayout(SDL_Surface const* s)
+{
+	if (not hasPixelOpsLayout(s))
+	{
+		throw Error{"Surface is not 32-bit with alpha in the top byte"};
+	}
+}
+
+template<typename RowOp>
+void compose(SDL_Surface* dst, SDL_Surface* src, Rect r, RowOp op)
+{
+	requirePixelOpsLayout(dst);
+	requirePixelOpsLayout(src);
+
+	SDL_Rect target = r;
+	auto clipped = clip(dst, target);
+	auto sx = clipped.x - target.x;
+	auto sy = clipped.y - target.y;
+
+	SurfaceLock dstLock{dst};
+	SurfaceLock srcLock{src};
+	for (int y = 0; y < clipped.h; ++y)
+	{
+		auto d = pixelRow(dst, clipped.y + y, clipped.x, clipped.w);
+		auto s = pixelRow(src, sy + y, sx, clipped.w);
+		op(d, s);
+	}
+}
+}
+
 Surface::Surface(Size size)
 	: surface{createSurface(size)}
 {}
@@ -48,12 +133,42 @@ Surface::Surface(std::filesystem::path const& fname)
 	}
 }
 
+Surface::Surface(Archive const& archive, std::string_view name)
+{
+	auto const& entry = archive.at(name);
+	if (entry.kind == Archive::Kind::Raw)
+	{
+		auto rw = SDL_RWFromConstMem(entry.data.data(), static_cast<int>(entry.data.size()));
+		surface = IMG_Load_RW(rw, 1);
+		if (surface == nullptr)
+		{
+			throw Error{IMG_GetError()};
+		}
+		return;
+	}
+
+	surface = SDL_CreateRGBSurfaceWithFormat(0, entry.width, entry.height, 32, entry.format);
+	if (surface == nullptr)
+	{
+		throw Error{SDL_GetError()};
+	}
+	auto pixels = static_cast<std::byte*>(surface->pixels);
+	for (int y = 0; y < entry.height; ++y)
+	{
+		std::memcpy(pixels + y * surface->pitch, entry.data.data() + y * entry.pitch, static_cast<std::size_t>(entry.width) * 4);
+	}
+}
+
 Surface::Surface(Surface&& other) noexcept
 	: surface{other.surface}
-	, texture{other.texture}
+	, pool{other.pool}
+	, primary{std::move(other.primary)}
+	, others{std::move(other.others)}
 {
 	other.surface = nullptr;
-	other.texture = nullptr;
+	other.pool = nullptr;
+	other.primary = {};
+	other.others.clear();
 }
 
 Surface& Surface::operator=(Surface&& other) noexcept
@@ -61,10 +176,14 @@ Surface& Surface::operator=(Surface&& other) noexcept
 	release();
 
 	surface = other.surface;
-	texture = other.texture;
+	pool = other.pool;
+	primary = std::move(other.primary);
+	others = std::move(other.others);
 
 	other.surface = nullptr;
-	other.texture = nullptr;
+	other.pool = nullptr;
+	other.primary = {};
+	other.others.clear();
 
 	return *this;
 }
@@ -76,7 +195,22 @@ Surface::~Surface() noexcept
 
 void Surface::release() noexcept
 {
-	SDL_DestroyTexture(texture);
+	destroyTexture(primary);
+	for (auto& cached: others)
+	{
+		destroyTexture(cached);
+	}
+	others.clear();
+
+	if (pool != nullptr and surface != nullptr)
+	{
+		// the pixels were handed to SDL as preallocated, so they outlive the surface
+		auto pixels = surface->pixels;
+		auto bytes = static_cast<std::size_t>(surface->pitch) * static_cast<std::size_t>(surface->h);
+		SDL_FreeSurface(surface);
+		pool->recycle(pixels, bytes);
+		return;
+	}
 	SDL_FreeSurface(surface);
 }
 
@@ -90,43 +224,369 @@ Size Surface::getSize() const noexcept
 SDL_Texture* Surface::getTexture(Renderer const& renderer) const
 {
 	std::unique_lock hold{mutex};
-	if (texture == nullptr)
+	auto& cached = findTexture(renderer);
+	if (cached.texture == nullptr)
 	{
-		texture = SDL_CreateTextureFromSurface(renderer.get(), surface);
-		if (texture == nullptr)
+		createTexture(cached, renderer);
+	}
+	else if (not cached.dirty.empty())
+	{
+		if (cached.streaming)
+		{
+			uploadDirty(cached);
+		}
+		else
+		{
+			SDL_DestroyTexture(cached.texture);
+			SDLPP_PROFILE_COUNT(TextureDestructions, 1);
+			cached.texture = nullptr;
+			createTexture(cached, renderer);
+		}
+	}
+	return cached.texture;
+}
+
+Surface::CachedTexture& Surface::findTexture(Renderer const& renderer) const
+{
+	auto matches = [&renderer](CachedTexture const& cached)
+	{
+		return cached.renderer == &renderer and not cached.alive.expired();
+	};
+
+	// fast path: a surface is normally only ever drawn by one renderer
+	if (matches(primary))
+	{
+		return primary;
+	}
+	for (auto& cached: others)
+	{
+		if (matches(cached))
+		{
+			return cached;
+		}
+	}
+
+	// reuse a slot whose renderer is gone, its textures died with it
+	auto stale = [](CachedTexture const& cached)
+	{
+		return cached.renderer == nullptr or cached.alive.expired();
+	};
+	CachedTexture* slot = nullptr;
+	if (stale(primary))
+	{
+		slot = &primary;
+	}
+	else
+	{
+		for (auto& cached: others)
+		{
+			if (stale(cached))
+			{
+				slot = &cached;
+				break;
+			}
+		}
+	}
+	if (slot == nullptr)
+	{
+		slot = &others.emplace_back();
+	}
+
+	*slot = {};
+	slot->renderer = &renderer;
+	slot->alive = renderer.getLifetime();
+	return *slot;
+}
+
+void Surface::destroyTexture(CachedTexture& cached) noexcept
+{
+	// a destroyed renderer has already taken its textures with it
+	if (cached.texture != nullptr and not cached.alive.expired())
+	{
+		SDL_DestroyTexture(cached.texture);
+		SDLPP_PROFILE_COUNT(TextureDestructions, 1);
+	}
+	cached = {};
+}
+
+void Surface::createTexture(CachedTexture& cached, Renderer const& renderer) const
+{
+	SDLPP_PROFILE_ZONE("Surface::createTexture");
+	SDLPP_PROFILE_COUNT(TextureCreations, 1);
+	cached.dirty.clear();
+	// markDirty is noexcept: it must never have to grow the list
+	cached.dirty.reserve(maxDirtyRects);
+
+	// colour-keyed and non-32-bit surfaces need SDL's conversion
+	cached.streaming = surface->format->BytesPerPixel == 4 and not SDL_HasColorKey(surface);
+	if (not cached.streaming)
+	{
+		cached.texture = SDL_CreateTextureFromSurface(renderer.get(), surface);
+		if (cached.texture == nullptr)
 		{
 			throw Error{SDL_GetError()};
 		}
+		return;
+	}
+
+	cached.texture = SDL_CreateTexture(
+		renderer.get(), surface->format->format,
+		SDL_TEXTUREACCESS_STREAMING, surface->w, surface->h
+	);
+	if (cached.texture == nullptr)
+	{
+		throw Error{SDL_GetError()};
 	}
-	return texture;
+
+	// carry over what SDL_CreateTextureFromSurface would
+	SDL_BlendMode mode;
+	std::uint8_t r, g, b, a;
+	SDL_GetSurfaceBlendMode(surface, &mode);
+	SDL_GetSurfaceColorMod(surface, &r, &g, &b);
+	SDL_GetSurfaceAlphaMod(surface, &a);
+	SDL_SetTextureBlendMode(cached.texture, mode);
+	SDL_SetTextureColorMod(cached.texture, r, g, b);
+	SDL_SetTextureAlphaMod(cached.texture, a);
+
+	cached.dirty.push_back({0, 0, surface->w, surface->h});
+	uploadDirty(cached);
+}
+
+void Surface::uploadDirty(CachedTexture& cached) const
+{
+	auto pixels = static_cast<std::uint8_t const*>(surface->pixels);
+	for (auto const& r: cached.dirty)
+	{
+		auto first = pixels + r.y * surface->pitch + r.x * surface->format->BytesPerPixel;
+		if (SDL_UpdateTexture(cached.texture, &r, first, surface->pitch) < 0)
+		{
+			throw Error{SDL_GetError()};
+		}
+		SDLPP_PROFILE_COUNT(TextureUploads, 1);
+	}
+	cached.dirty.clear();
+}
+
+SDL_Surface* Surface::get() const noexcept
+{
+	return surface;
 }
 
 void Surface::invalidateTexture() noexcept
 {
-	SDL_DestroyTexture(texture);
-	texture = nullptr;
+	markDirty({0, 0, surface->w, surface->h});
+}
+
+void Surface::markDirty(SDL_Rect r) noexcept
+{
+	r = clip(surface, r);
+	if (r.w <= 0 or r.h <= 0)
+	{
+		return;
+	}
+
+	std::unique_lock hold{mutex};
+	addDirty(primary.dirty, primary, r);
+	for (auto& cached: others)
+	{
+		addDirty(cached.dirty, cached, r);
+	}
+}
+
+void Surface::addDirty(std::vector<SDL_Rect>& dirty, CachedTexture const& cached, SDL_Rect r) noexcept
+{
+	if (cached.texture == nullptr)
+	{
+		return;  // the whole surface is uploaded when the texture is created
+	}
+
+	// absorb every rect that overlaps or touches r, then store the union
+	auto touches = [](SDL_Rect const& a, SDL_Rect const& b)
+	{
+		return a.x <= b.x + b.w and b.x <= a.x + a.w and a.y <= b.y + b.h and b.y <= a.y + a.h;
+	};
+	auto unite = [](SDL_Rect const& a, SDL_Rect const& b) -> SDL_Rect
+	{
+		auto x0 = std::min(a.x, b.x);
+		auto y0 = std::min(a.y, b.y);
+		auto x1 = std::max(a.x + a.w, b.x + b.w);
+		auto y1 = std::max(a.y + a.h, b.y + b.h);
+		return {x0, y0, x1 - x0, y1 - y0};
+	};
+
+	for (auto i = dirty.size(); i-- > 0;)
+	{
+		if (touches(dirty[i], r))
+		{
+			r = unite(dirty[i], r);
+			dirty.erase(dirty.begin() + static_cast<std::ptrdiff_t>(i));
+			i = dirty.size();  // the grown rect may now touch ones already checked
+		}
+	}
+
+	if (dirty.size() == maxDirtyRects)
+	{
+		// too fragmented, a single bounding upload is cheaper than many small ones
+		for (auto const& d: dirty)
+		{
+			r = unite(d, r);
+		}
+		dirty.clear();
+	}
+	dirty.push_back(r);  // within the capacity reserved by createTexture
 }
 
 void Surface::putPixel(Point p, Color c) noexcept
 {
-	auto offset = 4 * (p.y * surface->w + p.x);
-	auto pixels = static_cast<uint8_t*>(surface->pixels);
-	pixels[offset+0] = c.b;
-	pixels[offset+1] = c.g;
-	pixels[offset+2] = c.r;
-	pixels[offset+3] = c.a;
+	if (not p.in(Rect{{0, 0}, {surface->w, surface->h}}) or surface->format->BytesPerPixel != 4)
+	{
+		return;
+	}
+	if (SDL_MUSTLOCK(surface) and SDL_LockSurface(surface) < 0)
+	{
+		return;
+	}
+
+	pixelRow(surface, p.y, p.x, 1)[0] = SDL_MapRGBA(surface->format, c.r, c.g, c.b, c.a);
 
-	invalidateTexture();
+	if (SDL_MUSTLOCK(surface))
+	{
+		SDL_UnlockSurface(surface);
+	}
+	markDirty({p.x, p.y, 1, 1});
+}
+
+PixelView Surface::lockPixels()
+{
+	return PixelView{*this};
+}
+
+PixelView::PixelView(Surface& s)
+	: owner{&s}
+	, surface{s.surface}
+{
+	if (surface->format->BytesPerPixel != 4)
+	{
+		throw Error{"PixelView requires a 32-bit surface"};
+	}
+	if (SDL_MUSTLOCK(surface) and SDL_LockSurface(surface) < 0)
+	{
+		throw Error{SDL_GetError()};
+	}
+}
+
+PixelView::PixelView(PixelView&& other) noexcept
+	: owner{other.owner}
+	, surface{other.surface}
+{
+	other.owner = nullptr;
+}
+
+PixelView::~PixelView() noexcept
+{
+	if (owner == nullptr)
+	{
+		return;
+	}
+	if (SDL_MUSTLOCK(surface))
+	{
+		SDL_UnlockSurface(surface);
+	}
+	owner->invalidateTexture();
+}
+
+Size PixelView::getSize() const noexcept
+{
+	return {surface->w, surface->h};
+}
+
+std::span<std::uint32_t> PixelView::row(int y) const noexcept
+{
+	return pixelRow(surface, y, 0, surface->w);
+}
+
+std::uint32_t& PixelView::operator[](Point p) const noexcept
+{
+	return row(p.y)[static_cast<std::size_t>(p.x)];
+}
+
+PixelRows PixelView::rows(int begin, int end) const noexcept
+{
+	begin = std::clamp(begin, 0, surface->h);
+	end = std::clamp(end, begin, surface->h);
+	auto first = static_cast<std::uint8_t*>(surface->pixels) + begin * surface->pitch;
+	return {first, surface->pitch, surface->w, end - begin};
+}
+
+PixelRows PixelView::rows() const noexcept
+{
+	return rows(0, surface->h);
+}
+
+std::uint32_t PixelView::map(Color c) const noexcept
+{
+	return SDL_MapRGBA(surface->format, c.r, c.g, c.b, c.a);
+}
+
+Color PixelView::unmap(std::uint32_t pixel) const noexcept
+{
+	Color c;
+	SDL_GetRGBA(pixel, surface->format, &c.r, &c.g, &c.b, &c.a);
+	return c;
 }
 
 void Surface::fillRect(Rect r, Color c)
 {
 	SDL_Rect dst = r;
-	if (SDL_FillRect(surface, &dst, SDL_MapRGBA(surface->format, c.r, c.g, c.b, c.a)) < 0)
+	auto pixel = SDL_MapRGBA(surface->format, c.r, c.g, c.b, c.a);
+	if (hasPixelOpsLayout(surface))
+	{
+		auto clipped = clip(surface, dst);
+		SurfaceLock lock{surface};
+		for (int y = 0; y < clipped.h; ++y)
+		{
+			PixelOps::fill(pixelRow(surface, clipped.y + y, clipped.x, clipped.w), pixel);
+		}
+	}
+	else if (SDL_FillRect(surface, &dst, pixel) < 0)
 	{
 		throw Error{SDL_GetError()};
 	}
-	invalidateTexture();
+	markDirty(dst);
+}
+
+void Surface::blendRect(Rect r, Color c)
+{
+	requirePixelOpsLayout(surface);
+	auto pixel = SDL_MapRGBA(surface->format, c.r, c.g, c.b, c.a);
+	auto clipped = clip(surface, r);
+	SurfaceLock lock{surface};
+	for (int y = 0; y < clipped.h; ++y)
+	{
+		PixelOps::blendFill(pixelRow(surface, clipped.y + y, clipped.x, clipped.w), pixel);
+	}
+	markDirty(clipped);
+}
+
+void Surface::blitPremultiplied(Surface const& other, Point p, Alignment align)
+{
+	Rect target{p, other.getSize(), align};
+	compose(surface, other.surface, target, [](auto dst, auto src)
+	{
+		PixelOps::blitOver(dst, src);
+	});
+	markDirty(target);
+}
+
+void Surface::blitColorKey(Surface const& other, Color key, Point p, Alignment align)
+{
+	auto k = SDL_MapRGBA(other.surface->format, key.r, key.g, key.b, key.a);
+	Rect target{p, other.getSize(), align};
+	compose(surface, other.surface, target, [k](auto dst, auto src)
+	{
+		PixelOps::blitColorKey(dst, src, k);
+	});
+	markDirty(target);
 }
 
 void Surface::blit(Surface const& other, Point p, Alignment align)
@@ -136,5 +596,6 @@ void Surface::blit(Surface const& other, Point p, Alignment align)
 	{
 		throw Error{SDL_GetError()};
 	}
+	markDirty(dst);  // SDL_BlitSurface leaves the clipped destination in dst
 }
 }
@@ -0,0 +1,171 @@
+#include "sdlpp/surfacepool.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstdlib>
+#include <cstring>
+
+#include <SDL2/SDL.h>
+
+#include "sdlpp/error.h"
+
+namespace SDL
+{
+namespace
+{
+constexpr std::size_t bufferAlignment = 64;
+}
+
+SurfacePool::SurfacePool(std::size_t idleBudget_)
+	: idleBudget{idleBudget_}
+{}
+
+SurfacePool::~SurfacePool() noexcept
+{
+	trim();
+}
+
+Surface SurfacePool::acquire(Size size)
+{
+	if (size.w <= 0 or size.h <= 0)
+	{
+		throw Error{"Invalid surface size"};
+	}
+
+	auto pitch = static_cast<std::size_t>(size.w) * 4;
+	auto bytes = pitch * static_cast<std::size_t>(size.h);
+	auto c = sizeClass(bytes);
+	if (c >= classCount)
+	{
+		throw Error{"Surface too large for the pool"};
+	}
+	auto capacity = std::size_t{1} << (c + minClass);
+
+	void* pixels = nullptr;
+	{
+		std::unique_lock hold{mutex};
+		if (not idle[c].empty())
+		{
+			pixels = idle[c].back();
+			idle[c].pop_back();
+			stats.idleBytes -= capacity;
+			++stats.reuses;
+		}
+		else
+		{
+			++stats.allocations;
+		}
+		stats.liveBytes += capacity;
+	}
+
+	if (pixels == nullptr)
+	{
+		pixels = std::aligned_alloc(bufferAlignment, capacity);
+		if (pixels == nullptr)
+		{
+			std::unique_lock hold{mutex};
+			stats.liveBytes -= capacity;
+			throw Error{"Out of memory"};
+		}
+	}
+	std::memset(pixels, 0, bytes);
+
+	auto s = SDL_CreateRGBSurfaceWithFormatFrom(pixels, size.w, size.h, 32, static_cast<int>(pitch), SDL_PIXELFORMAT_RGBA32);
+	if (s == nullptr)
+	{
+		recycle(pixels, bytes);
+		throw Error{SDL_GetError()};
+	}
+	// SDL_CreateRGBSurface leaves new surfaces ready for alpha blending
+	SDL_SetSurfaceBlendMode(s, SDL_BLENDMODE_BLEND);
+
+	Surface result{s};
+	result.pool = this;
+	return result;
+}
+
+void SurfacePool::trim() noexcept
+{
+	std::unique_lock hold{mutex};
+	for (auto& list: idle)
+	{
+		for (auto p: list)
+		{
+			std::free(p);
+		}
+		stats.frees += list.size();
+		list.clear();
+	}
+	stats.idleBytes = 0;
+}
+
+SurfacePool::Stats SurfacePool::getStats() const noexcept
+{
+	std::unique_lock hold{mutex};
+	return stats;
+}
+
+void SurfacePool::resetCounters() noexcept
+{
+	std::unique_lock hold{mutex};
+	stats.allocations = 0;
+	stats.reuses = 0;
+	stats.releases = 0;
+	stats.frees = 0;
+}
+
+std::size_t SurfacePool::sizeClass(std::size_t bytes) noexcept
+{
+	auto bits = static_cast<std::size_t>(std::bit_width(std::max(bytes, std::size_t{1} << minClass) - 1));
+	return bits - minClass;
+}
+
+void SurfacePool::recycle(void* pixels, std::size_t bytes) noexcept
+{
+	auto c = sizeClass(bytes);
+	auto capacity = std::size_t{1} << (c + minClass);
+
+	std::unique_lock hold{mutex};
+	++stats.releases;
+	stats.liveBytes -= capacity;
+	if (stats.idleBytes + capacity > idleBudget)
+	{
+		++stats.frees;
+		hold.unlock();
+		std::free(pixels);
+		return;
+	}
+	try
+	{
+		idle[c].push_back(pixels);
+	}
+	catch (...)
+	{
+		// no room to keep it idle, give it back instead
+		++stats.frees;
+		hold.unlock();
+		std::free(pixels);
+		return;
+	}
+	stats.idleBytes += capacity;
+}
+
+SurfaceArena::SurfaceArena(SurfacePool& pool_)
+	: pool{pool_}
+{}
+
+Surface& SurfaceArena::make(Size size)
+{
+	return surfaces.emplace_back(pool.acquire(size));
+}
+
+void SurfaceArena::reset() noexcept
+{
+	surfaces.clear();
+}
+
+std::size_t SurfaceArena::size() const noexcept
+{
+	return surfaces.size();
+}
+}
@@ -0,0 +1,115 @@
+#include "sdlpp/textcache.h"
+
+#include <functional>
+
+#include "sdlpp/font.h"
+#include "sdlpp/video.h"
+
+namespace SDL
+{
+namespace
+{
+std::size_t hashKey(std::string_view text, int ptsize, Color color, std::optional<unsigned int> width) noexcept
+{
+	auto h = std::hash<std::string_view>{}(text);
+	auto mix = [&h](std::size_t v)
+	{
+		h ^= v + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2);
+	};
+	mix(static_cast<std::size_t>(ptsize));
+	mix((std::size_t{color.r} << 24) | (std::size_t{color.g} << 16) | (std::size_t{color.b} << 8) | color.a);
+	mix(width.has_value() ? *width + 1 : 0);
+	return h;
+}
+}
+
+std::size_t TextCache::KeyHash::operator()(Key const& k) const noexcept
+{
+	return hashKey(k.text, k.ptsize, k.color, k.width);
+}
+
+std::size_t TextCache::KeyHash::operator()(KeyView const& k) const noexcept
+{
+	return hashKey(k.text, k.ptsize, k.color, k.width);
+}
+
+TextCache::TextCache(Font const& font_, Renderer& renderer_, std::size_t budget_)
+	: font{font_}
+	, renderer{renderer_}
+	, budget{budget_}
+{}
+
+Surface const& TextCache::render(std::string_view text, int ptsize, Color color)
+{
+	return get({text, ptsize, color, std::nullopt});
+}
+
+Surface const& TextCache::renderWrapped(std::string_view text, int ptsize, unsigned int width, Color color)
+{
+	return get({text, ptsize, color, width});
+}
+
+Surface const& TextCache::get(KeyView key)
+{
+	if (auto it = index.find(key); it != index.end())
+	{
+		++stats.hits;
+		lru.splice(lru.begin(), lru, it->second);
+		return it->second->second.surface;
+	}
+
+	++stats.misses;
+	std::string text{key.text};
+	auto surface = key.width.has_value()
+		? font.renderWrapped(text, key.ptsize, *key.width, key.color)
+		: font.render(text, key.ptsize, key.color);
+	surface.getTexture(renderer);  // upload now so that drawing a hit never does
+
+	auto bytes = static_cast<std::size_t>(surface.get()->pitch) * surface.get()->h;
+	lru.emplace_front(Key{std::move(text), key.ptsize, key.color, key.width}, Entry{std::move(surface), bytes});
+	index.insert({lru.front().first, lru.begin()});
+	stats.bytes += bytes;
+
+	evict();
+	return lru.front().second.surface;
+}
+
+void TextCache::setBudget(std::size_t budget_)
+{
+	budget = budget_;
+	evict();
+}
+
+void TextCache::evict()
+{
+	while (stats.bytes > budget and lru.size() > 1)
+	{
+		auto& [key, entry] = lru.back();
+		stats.bytes -= entry.bytes;
+		++stats.evictions;
+		index.erase(key);
+		lru.pop_back();
+	}
+}
+
+void TextCache::clear() noexcept
+{
+	index.clear();
+	lru.clear();
+	stats.bytes = 0;
+}
+
+TextCache::Stats TextCache::getStats() const noexcept
+{
+	auto s = stats;
+	s.entries = lru.size();
+	return s;
+}
+
+void TextCache::resetCounters() noexcept
+{
+	stats.hits = 0;
+	stats.misses = 0;
+	stats.evictions = 0;
+}
+}
@@ -0,0 +1,229 @@
+#include "sdlpp/tilemap.h"
+
+#include <algorithm>
+
+#include "sdlpp/error.h"
+#include "sdlpp/pixel.h"
+#include "sdlpp/profiler.h"
+#include "sdlpp/surface.h"
+#include "sdlpp/video.h"
+
+namespace SDL
+{
+namespace
+{
+int ceilDiv(int a, int b) noexcept
+{
+	return (a + b - 1) / b;
+}
+
+int floorDiv(int a, int b) noexcept
+{
+	return a >= 0 ? a / b : -((-a + b - 1) / b);
+}
+}
+
+TileMap::TileMap(Renderer& renderer_, Surface const& tileset_, Size tileSize_, Size mapSize_, int chunkTiles_)
+	: renderer{renderer_}
+	, tileset{tileset_}
+	, tileSize{tileSize_}
+	, mapSize{mapSize_}
+	, chunkTiles{chunkTiles_}
+	, chunkCount{ceilDiv(mapSize_.w, chunkTiles_), ceilDiv(mapSize_.h, chunkTiles_)}
+	, tilesetColumns{tileSize_.w > 0 ? tileset_.getSize().w / tileSize_.w : 0}
+	, tiles(static_cast<std::size_t>(mapSize_.w) * static_cast<std::size_t>(mapSize_.h), empty)
+	, chunks(static_cast<std::size_t>(chunkCount.w) * static_cast<std::size_t>(chunkCount.h))
+{
+	if (tileSize.w <= 0 or tileSize.h <= 0 or chunkTiles <= 0 or tilesetColumns == 0)
+	{
+		throw Error{"Invalid tile map geometry"};
+	}
+}
+
+Size TileMap::getSize() const noexcept
+{
+	return mapSize;
+}
+
+Size TileMap::getPixelSize() const noexcept
+{
+	return {mapSize.w * tileSize.w, mapSize.h * tileSize.h};
+}
+
+TileMap::Tile TileMap::get(Point tile) const noexcept
+{
+	if (not tile.in({{0, 0}, mapSize}))
+	{
+		return empty;
+	}
+	return tiles[static_cast<std::size_t>(tile.y * mapSize.w + tile.x)];
+}
+
+void TileMap::set(Point tile, Tile t) noexcept
+{
+	if (not tile.in({{0, 0}, mapSize}))
+	{
+		return;
+	}
+	auto& slot = tiles[static_cast<std::size_t>(tile.y * mapSize.w + tile.x)];
+	if (slot != t)
+	{
+		slot = t;
+		chunkAt({tile.x / chunkTiles, tile.y / chunkTiles}).dirty = true;
+	}
+}
+
+void TileMap::fill(Rect r, Tile t) noexcept
+{
+	auto x0 = std::max(r.p.x, 0);
+	auto y0 = std::max(r.p.y, 0);
+	auto x1 = std::min(r.p.x + r.s.w, mapSize.w);
+	auto y1 = std::min(r.p.y + r.s.h, mapSize.h);
+	for (int y = y0; y < y1; ++y)
+	{
+		for (int x = x0; x < x1; ++x)
+		{
+			set({x, y}, t);
+		}
+	}
+}
+
+void TileMap::invalidate() noexcept
+{
+	for (auto& c: chunks)
+	{
+		c.dirty = true;
+	}
+}
+
+void TileMap::draw(Point camera)
+{
+	auto viewport = renderer.getViewport();
+	Rect visible{camera, viewport.s};
+
+	for (auto& c: chunks)
+	{
+		c.visible = false;
+	}
+	stats.visibleChunks = 0;
+	stats.renderedChunks = 0;
+
+	// only the chunk range under the viewport is looked at
+	Size chunkPixels{chunkTiles * tileSize.w, chunkTiles * tileSize.h};
+	auto cx0 = std::max(floorDiv(visible.p.x, chunkPixels.w), 0);
+	auto cy0 = std::max(floorDiv(visible.p.y, chunkPixels.h), 0);
+	auto cx1 = std::min(floorDiv(visible.p.x + visible.s.w - 1, chunkPixels.w) + 1, chunkCount.w);
+	auto cy1 = std::min(floorDiv(visible.p.y + visible.s.h - 1, chunkPixels.h) + 1, chunkCount.h);
+
+	for (int cy = cy0; cy < cy1; ++cy)
+	{
+		for (int cx = cx0; cx < cx1; ++cx)
+		{
+			auto area = this->chunkPixels({cx, cy});
+			if (not area.intersects(visible))
+			{
+				continue;
+			}
+
+			auto& c = chunkAt({cx, cy});
+			if (c.dirty or not c.target)
+			{
+				render({cx, cy}, c);
+			}
+			c.visible = true;
+			++stats.visibleChunks;
+
+			renderer.copySurface(*c.target, {area.p.x - camera.x, area.p.y - camera.y});
+		}
+	}
+}
+
+void TileMap::releaseHidden() noexcept
+{
+	for (auto& c: chunks)
+	{
+		if (not c.visible)
+		{
+			c.target.reset();
+		}
+	}
+}
+
+TileMap::Stats TileMap::getStats() const noexcept
+{
+	auto s = stats;
+	s.cachedChunks = static_cast<std::size_t>(std::count_if(chunks.begin(), chunks.end(), [](Chunk const& c)
+	{
+		return c.target.has_value();
+	}));
+	return s;
+}
+
+TileMap::Chunk& TileMap::chunkAt(Point chunk) noexcept
+{
+	return chunks[static_cast<std::size_t>(chunk.y * chunkCount.w + chunk.x)];
+}
+
+Rect TileMap::chunkPixels(Point chunk) const noexcept
+{
+	// chunks on the right and bottom edges may be partial
+	auto tx = chunk.x * chunkTiles;
+	auto ty = chunk.y * chunkTiles;
+	auto w = std::min(chunkTiles, mapSize.w - tx);
+	auto h = std::min(chunkTiles, mapSize.h - ty);
+	return {{tx * tileSize.w, ty * tileSize.h}, {w * tileSize.w, h * tileSize.h}};
+}
+
+void TileMap::render(Point chunk, Chunk& c)
+{
+	SDLPP_PROFILE_ZONE("TileMap::render");
+	auto area = chunkPixels(chunk);
+	if (not c.target)
+	{
+		c.target.emplace(renderer, Size{chunkTiles * tileSize.w, chunkTiles * tileSize.h});
+	}
+
+	// tiles never overlap, so copying them without blending is exact and the
+	// chunk keeps the tileset's alpha for when it is composited
+	auto texture = tileset.getTexture(renderer);
+	SDL_BlendMode mode;
+	SDL_GetTextureBlendMode(texture, &mode);
+	SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_NONE);
+
+	auto batching = renderer.isBatching();
+	try
+	{
+		auto scope = renderer.setTarget(*c.target);
+		renderer.clear(Color{0, 0, 0, 0});
+		renderer.setBatching(true);
+
+		auto tx0 = chunk.x * chunkTiles;
+		auto ty0 = chunk.y * chunkTiles;
+		for (int y = 0; y < area.s.h / tileSize.h; ++y)
+		{
+			for (int x = 0; x < area.s.w / tileSize.w; ++x)
+			{
+				auto t = tiles[static_cast<std::size_t>((ty0 + y) * mapSize.w + tx0 + x)];
+				if (t == empty)
+				{
+					continue;
+				}
+				Rect src{{(t % tilesetColumns) * tileSize.w, (t / tilesetColumns) * tileSize.h}, tileSize};
+				renderer.copySurface(tileset, src, {x * tileSize.w, y * tileSize.h});
+			}
+		}
+		renderer.flush();
+	}
+	catch (...)
+	{
+		renderer.setBatching(batching);
+		SDL_SetTextureBlendMode(texture, mode);
+		throw;
+	}
+	renderer.setBatching(batching);
+	SDL_SetTextureBlendMode(texture, mode);
+
+	c.dirty = false;
+	++stats.renderedChunks;
+}
+}
@@ -1,7 +1,14 @@
 #include "sdlpp/video.h"
 
+#include <algorithm>
+#include <tuple>
+
+#include "sdlpp/atlas.h"
 #include "sdlpp/error.h"
+#include "sdlpp/glyphatlas.h"
 #include "sdlpp/pixel.h"
+#include "sdlpp/profiler.h"
+#include "sdlpp/rendertarget.h"
 #include "sdlpp/surface.h"
 
 namespace SDL
@@ -51,11 +58,13 @@ Renderer::Renderer(Window& w)
 
 Renderer::~Renderer() noexcept
 {
+	lifetime.reset();
 	SDL_DestroyRenderer(renderer);
 }
 
 void Renderer::clear(Color c)
 {
+	batch.commands.clear();  // everything recorded so far would be cleared anyway
 	setColor(c);
 	if (SDL_RenderClear(renderer) < 0)
 	{
@@ -63,8 +72,11 @@ void Renderer::clear(Color c)
 	}
 }
 
-void Renderer::present() noexcept
+void Renderer::present()
 {
+	SDLPP_PROFILE_PRESENT();
+	SDLPP_PROFILE_ZONE("Renderer::present");
+	flush();
 	SDL_RenderPresent(renderer);
 }
 
@@ -91,7 +103,68 @@ void Renderer::copySurface(Surface const& s, Rect r, Point p, Alignment align)
 	SDL_Rect src = r;
 	SDL_Rect dst = Rect{p, r.s, align};
 
-	if (SDL_RenderCopy(renderer, s.getTexture(*this), &src, &dst) < 0)
+	copyTexture(s.getTexture(*this), src, dst);
+}
+
+void Renderer::copySurface(AtlasHandle h, Point p, Alignment align)
+{
+	auto texture = h.atlas->getTexture(h);
+	if (texture == nullptr)
+	{
+		return; // stale handle
+	}
+
+	auto r = h.atlas->getRect(h);
+	SDL_Rect src = r;
+	SDL_Rect dst = Rect{p, r.s, align};
+
+	copyTexture(texture, src, dst);
+}
+
+void Renderer::copySurface(RenderTarget const& t, Point p, Alignment align)
+{
+	copySurface(t, {{}, t.getSize()}, p, align);
+}
+
+void Renderer::copySurface(RenderTarget const& t, Rect r, Point p, Alignment align)
+{
+	SDL_Rect src = r;
+	SDL_Rect dst = Rect{p, r.s, align};
+
+	copyTexture(t.get(), src, dst);
+}
+
+TargetScope Renderer::setTarget(RenderTarget& target)
+{
+	return {*this, target};
+}
+
+void Renderer::copyTexture(SDL_Texture* texture, SDL_Rect const& src, SDL_Rect const& dst, Color tint)
+{
+	if (batch.enabled)
+	{
+		record(DrawKind::Copy, tint, src, dst, texture);
+		return;
+	}
+
+	// the texture's own modulation is restored afterwards, not reset to white
+	auto tinted = tint != Color::White;
+	Color saved = Color::White;
+	if (tinted)
+	{
+		SDL_GetTextureColorMod(texture, &saved.r, &saved.g, &saved.b);
+		SDL_GetTextureAlphaMod(texture, &saved.a);
+		SDL_SetTextureColorMod(texture, tint.r, tint.g, tint.b);
+		SDL_SetTextureAlphaMod(texture, tint.a);
+	}
+	auto result = SDL_RenderCopy(renderer, texture, &src, &dst);
+	SDLPP_PROFILE_COUNT(DrawCalls, 1);
+	if (tinted)
+	{
+		SDL_SetTextureColorMod(texture, saved.r, saved.g, saved.b);
+		SDL_SetTextureAlphaMod(texture, saved.a);
+	}
+	if (result < 0)
 	{
 		throw Error{SDL_GetError()};
 	}
@@ -99,7 +172,14 @@ void Renderer::copySurface(Surface const& s, Rect r, Point p, Alignment align)
 
 void Renderer::drawLine(Point from, Point to, Color c)
 {
+	if (batch.enabled)
+	{
+		record(DrawKind::Line, c, {from.x, from.y, to.x, to.y});
+		return;
+	}
+
 	setColor(c);
+	SDLPP_PROFILE_COUNT(DrawCalls, 1);
 	if (SDL_RenderDrawLine(renderer, from.x, from.y, to.x, to.y) < 0)
 	{
 		throw Error{SDL_GetError()};
@@ -109,7 +189,14 @@ void Renderer::drawLine(Point from, Point to, Color c)
 void Renderer::drawRect(Rect r, Color c)
 {
 	SDL_Rect r_ = r;
+	if (batch.enabled)
+	{
+		record(DrawKind::Rect, c, r_);
+		return;
+	}
+
 	setColor(c);
+	SDLPP_PROFILE_COUNT(DrawCalls, 1);
 	if (SDL_RenderDrawRect(renderer, &r_) < 0)
 	{
 		throw Error{SDL_GetError()};
@@ -119,7 +206,14 @@ void Renderer::drawRect(Rect r, Color c)
 void Renderer::fillRect(Rect r, Color c)
 {
 	SDL_Rect r_ = r;
+	if (batch.enabled)
+	{
+		record(DrawKind::FillRect, c, r_);
+		return;
+	}
+
 	setColor(c);
+	SDLPP_PROFILE_COUNT(DrawCalls, 1);
 	if (SDL_RenderFillRect(renderer, &r_) < 0)
 	{
 		throw Error{SDL_GetError()};
@@ -128,18 +222,258 @@ void Renderer::fillRect(Rect r, Color c)
 
 void Renderer::putPixel(Point p, Color c)
 {
+	if (batch.enabled)
+	{
+		record(DrawKind::Point, c, {p.x, p.y, 0, 0});
+		return;
+	}
+
 	setColor(c);
+	SDLPP_PROFILE_COUNT(DrawCalls, 1);
 	if (SDL_RenderDrawPoint(renderer, p.x, p.y) < 0)
 	{
 		throw Error{SDL_GetError()};
 	}
 }
 
+void Renderer::drawText(GlyphAtlas& glyphs, std::string_view text, int ptsize, Point p, Color c)
+{
+	for (auto const& quad: glyphs.layout(text, ptsize))
+	{
+		auto h = glyphs.get(quad.codepoint, ptsize);
+		auto r = h.atlas->getRect(h);
+		SDL_Rect src = r;
+		SDL_Rect dst = Rect{p + static_cast<Vec2D>(quad.dst.p), r.s};
+		copyTexture(h.atlas->getTexture(h), src, dst, c);
+	}
+}
+
+void Renderer::setBlendMode(SDL_BlendMode mode)
+{
+	if (not batch.enabled and SDL_SetRenderDrawBlendMode(renderer, mode) < 0)
+	{
+		throw Error{SDL_GetError()};
+	}
+	blendMode = mode;
+}
+
+void Renderer::setBatching(bool enabled)
+{
+	if (not enabled)
+	{
+		flush();
+	}
+	batch.enabled = enabled;
+}
+
+bool Renderer::isBatching() const noexcept
+{
+	return batch.enabled;
+}
+
+namespace
+{
+constexpr std::uint32_t packColor(Color c) noexcept
+{
+	return (std::uint32_t{c.r} << 24) | (std::uint32_t{c.g} << 16) | (std::uint32_t{c.b} << 8) | c.a;
+}
+
+auto stateKey(auto const& cmd) noexcept
+{
+	return std::tuple{cmd.texture, cmd.blendMode, cmd.kind, packColor(cmd.color)};
+}
+}
+
+void Renderer::record(DrawKind kind, Color c, SDL_Rect a, SDL_Rect b, SDL_Texture* texture)
+{
+	auto rank = static_cast<std::uint32_t>(batch.commands.size());
+	batch.commands.push_back({texture, blendMode, c, kind, a, b, rank});
+}
+
+void Renderer::flush()
+{
+	auto& commands = batch.commands;
+	if (commands.empty())
+	{
+		return;
+	}
+	SDLPP_PROFILE_ZONE("Renderer::flush");
+
+	// group by state, then order the groups by when their state was first
+	// used: texture addresses alone would give an arbitrary order
+	std::stable_sort(commands.begin(), commands.end(), [](auto const& lhs, auto const& rhs)
+	{
+		return stateKey(lhs) < stateKey(rhs);
+	});
+	for (std::size_t i = 1; i < commands.size(); ++i)
+	{
+		if (stateKey(commands[i]) == stateKey(commands[i - 1]))
+		{
+			commands[i].rank = commands[i - 1].rank;
+		}
+	}
+	std::stable_sort(commands.begin(), commands.end(), [](auto const& lhs, auto const& rhs)
+	{
+		return lhs.rank < rhs.rank;
+	});
+
+	try
+	{
+		auto begin = commands.data();
+		auto const end = begin + commands.size();
+		while (begin != end)
+		{
+			auto runEnd = std::find_if(begin, end, [rank = begin->rank](auto const& cmd)
+			{
+				return cmd.rank != rank;
+			});
+			submitRun(begin, runEnd);
+			begin = runEnd;
+		}
+	}
+	catch (...)
+	{
+		commands.clear();
+		throw;
+	}
+
+	commands.clear();
+	if (SDL_SetRenderDrawBlendMode(renderer, blendMode) < 0)
+	{
+		throw Error{SDL_GetError()};
+	}
+}
+
+void Renderer::submitRun(DrawCommand const* begin, DrawCommand const* end)
+{
+	auto check = [](int result)
+	{
+		if (result < 0)
+		{
+			throw Error{SDL_GetError()};
+		}
+	};
+
+	auto count = static_cast<int>(end - begin);
+	if (begin->kind != DrawKind::Copy)
+	{
+		check(SDL_SetRenderDrawBlendMode(renderer, begin->blendMode));
+		setColor(begin->color);
+	}
+
+	auto& points = batch.points;
+	auto& rects = batch.rects;
+	points.clear();
+	rects.clear();
+
+	switch (begin->kind)
+	{
+		case DrawKind::Point:
+			for (auto cmd = begin; cmd != end; ++cmd)
+			{
+				points.push_back({cmd->a.x, cmd->a.y});
+			}
+			SDLPP_PROFILE_COUNT(DrawCalls, 1);
+			check(SDL_RenderDrawPoints(renderer, points.data(), count));
+			break;
+
+		case DrawKind::Line:
+			// connected segments are merged into a single polyline
+			for (auto cmd = begin; cmd != end; ++cmd)
+			{
+				SDL_Point from{cmd->a.x, cmd->a.y};
+				SDL_Point to{cmd->a.w, cmd->a.h};
+				if (not points.empty() and (points.back().x != from.x or points.back().y != from.y))
+				{
+					SDLPP_PROFILE_COUNT(DrawCalls, 1);
+					check(SDL_RenderDrawLines(renderer, points.data(), static_cast<int>(points.size())));
+					points.clear();
+				}
+				if (points.empty())
+				{
+					points.push_back(from);
+				}
+				points.push_back(to);
+			}
+			SDLPP_PROFILE_COUNT(DrawCalls, 1);
+			check(SDL_RenderDrawLines(renderer, points.data(), static_cast<int>(points.size())));
+			break;
+
+		case DrawKind::Rect:
+			for (auto cmd = begin; cmd != end; ++cmd)
+			{
+				rects.push_back(cmd->a);
+			}
+			SDLPP_PROFILE_COUNT(DrawCalls, 1);
+			check(SDL_RenderDrawRects(renderer, rects.data(), count));
+			break;
+
+		case DrawKind::FillRect:
+			for (auto cmd = begin; cmd != end; ++cmd)
+			{
+				rects.push_back(cmd->a);
+			}
+			SDLPP_PROFILE_COUNT(DrawCalls, 1);
+			check(SDL_RenderFillRects(renderer, rects.data(), count));
+			break;
+
+		case DrawKind::Copy:
+		{
+			int w, h;
+			check(SDL_QueryTexture(begin->texture, nullptr, nullptr, &w, &h));
+			auto tw = static_cast<float>(w);
+			auto th = static_cast<float>(h);
+
+			auto& vertices = batch.vertices;
+			auto& indices = batch.indices;
+			vertices.clear();
+			indices.clear();
+			for (auto cmd = begin; cmd != end; ++cmd)
+			{
+				auto const& src = cmd->a;
+				auto const& dst = cmd->b;
+				SDL_Color color = cmd->color;
+
+				auto x0 = static_cast<float>(dst.x);
+				auto y0 = static_cast<float>(dst.y);
+				auto x1 = static_cast<float>(dst.x + dst.w);
+				auto y1 = static_cast<float>(dst.y + dst.h);
+				auto u0 = static_cast<float>(src.x) / tw;
+				auto v0 = static_cast<float>(src.y) / th;
+				auto u1 = static_cast<float>(src.x + src.w) / tw;
+				auto v1 = static_cast<float>(src.y + src.h) / th;
+
+				auto base = static_cast<int>(vertices.size());
+				vertices.push_back({{x0, y0}, color, {u0, v0}});
+				vertices.push_back({{x1, y0}, color, {u1, v0}});
+				vertices.push_back({{x1, y1}, color, {u1, v1}});
+				vertices.push_back({{x0, y1}, color, {u0, v1}});
+				for (auto i: {0, 1, 2, 0, 2, 3})
+				{
+					indices.push_back(base + i);
+				}
+			}
+			SDLPP_PROFILE_COUNT(DrawCalls, 1);
+			check(SDL_RenderGeometry(
+				renderer, begin->texture,
+				vertices.data(), static_cast<int>(vertices.size()),
+				indices.data(), static_cast<int>(indices.size())
+			));
+			break;
+		}
+	}
+}
+
 SDL_Renderer* Renderer::get() const noexcept
 {
 	return renderer;
 }
 
+std::weak_ptr<void const> Renderer::getLifetime() const noexcept
+{
+	return lifetime;
+}
+
 void Renderer::setColor(Color c)
 {
 	if (SDL_SetRenderDrawColor(renderer, c.r, c.g, c.b, c.a) < 0)
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdio>
+#include <string>
+
+namespace Test
+{
+// counts failed expectations, main returns failed() as the exit status
+class Check
+{
+	public:
+		void expect(bool ok, std::string const& what)
+		{
+			if (not ok)
+			{
+				std::fprintf(stderr, "FAILED: %s\n", what.c_str());
+				++failures;
+			}
+		}
+
+		int failed() const noexcept
+		{
+			if (failures > 0)
+			{
+				std::fprintf(stderr, "%d check(s) failed\n", failures);
+			}
+			return failures > 0 ? 1 : 0;
+		}
+
+	private:
+		int failures = 0;
+};
+}
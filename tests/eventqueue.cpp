@@ -0,0 +1,176 @@
+#include "check.h"
+
+#include <atomic>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "sdlpp/events.h"
+#include "sdlpp/ringqueue.h"
+
+// every event pushed must be popped exactly once, in order per producer
+namespace
+{
+constexpr int perProducer = 20000;
+
+SDL::Event motion(int source, int sequence)
+{
+	SDL_Event raw{};
+	raw.motion.type = SDL_MOUSEMOTION;
+	raw.motion.windowID = static_cast<std::uint32_t>(source);
+	raw.motion.which = static_cast<std::uint32_t>(source);
+	raw.motion.x = sequence;
+	return SDL::Event::fromSdlEvent(raw);
+}
+
+// tallies what the consumers received, by producer and sequence number
+class Tally
+{
+	public:
+		Tally(int producers_)
+			: producers{producers_}
+			, seen(static_cast<std::size_t>(producers_ * perProducer))
+		{}
+
+		// called by one consumer with the events it got, in the order it got them
+		void record(std::vector<SDL::Event> const& events)
+		{
+			std::vector<int> last(static_cast<std::size_t>(producers), -1);
+			for (auto const& ev: events)
+			{
+				auto m = ev.mouseMotion();
+				auto p = static_cast<std::size_t>(m.windowId);
+				if (m.p.x <= last[p])
+				{
+					reordered = true;
+				}
+				last[p] = m.p.x;
+				seen[p * static_cast<std::size_t>(perProducer) + static_cast<std::size_t>(m.p.x)].fetch_add(1, std::memory_order_relaxed);
+			}
+		}
+
+		void verify(Test::Check& check, std::string const& name) const
+		{
+			std::size_t lost = 0;
+			std::size_t duplicated = 0;
+			for (auto const& count: seen)
+			{
+				lost += count.load() == 0;
+				duplicated += count.load() > 1;
+			}
+			check.expect(lost == 0, name + ": " + std::to_string(lost) + " events lost");
+			check.expect(duplicated == 0, name + ": " + std::to_string(duplicated) + " events delivered more than once");
+			check.expect(not reordered, name + ": events of a producer popped out of order");
+		}
+
+	private:
+		int producers;
+		std::vector<std::atomic<int>> seen;
+		std::atomic<bool> reordered{false};
+};
+
+void produce(std::vector<std::jthread>& threads, int producers, auto push)
+{
+	for (int p = 0; p < producers; ++p)
+	{
+		threads.emplace_back([p, push]
+		{
+			for (int i = 0; i < perProducer; ++i)
+			{
+				push(motion(p, i));
+			}
+		});
+	}
+}
+
+// EventQueue has a single consumer, which either polls or blocks
+void testEventQueue(Test::Check& check, int producers, bool blocking)
+{
+	SDL::EventQueue queue{256};
+	Tally tally{producers};
+	auto total = producers * perProducer;
+
+	std::vector<std::jthread> threads;
+	threads.emplace_back([&]
+	{
+		std::vector<SDL::Event> got;
+		got.reserve(static_cast<std::size_t>(total));
+		while (static_cast<int>(got.size()) < total)
+		{
+			if (blocking)
+			{
+				got.push_back(queue.wait_pop());
+			}
+			else if (auto ev = queue.try_pop())
+			{
+				got.push_back(std::move(*ev));
+			}
+			else if (queue.pop_many(got, 64) == 0)
+			{
+				std::this_thread::yield();
+			}
+		}
+		tally.record(got);
+	});
+	produce(threads, producers, [&queue](SDL::Event ev)
+	{
+		queue.push(std::move(ev));
+	});
+	threads.clear();
+
+	tally.verify(check, "EventQueue " + std::to_string(producers) + (blocking ? "x1 wait_pop" : "x1 try_pop"));
+	check.expect(queue.empty(), "EventQueue left events behind");
+}
+
+// RingQueue itself takes any number of consumers
+void testRingQueue(Test::Check& check, int producers, int consumers)
+{
+	SDL::RingQueue<SDL::Event> queue{256};
+	Tally tally{producers};
+	std::atomic<int> remaining{producers * perProducer};
+
+	std::vector<std::jthread> threads;
+	for (int c = 0; c < consumers; ++c)
+	{
+		threads.emplace_back([&]
+		{
+			std::vector<SDL::Event> got;
+			while (remaining.load(std::memory_order_relaxed) > 0)
+			{
+				auto n = queue.try_pop_many(std::back_inserter(got), 16);
+				if (n == 0)
+				{
+					std::this_thread::yield();
+				}
+				remaining.fetch_sub(static_cast<int>(n), std::memory_order_relaxed);
+			}
+			tally.record(got);
+		});
+	}
+	produce(threads, producers, [&queue](SDL::Event ev)
+	{
+		while (not queue.try_push(std::move(ev)))
+		{
+			std::this_thread::yield();
+		}
+	});
+	threads.clear();
+
+	tally.verify(check, "RingQueue " + std::to_string(producers) + "x" + std::to_string(consumers));
+	check.expect(queue.empty() and remaining == 0, "RingQueue left events behind");
+}
+}
+
+int main()
+{
+	Test::Check check;
+	for (auto producers: {1, 4})
+	{
+		testEventQueue(check, producers, false);
+		testEventQueue(check, producers, true);
+	}
+	testRingQueue(check, 1, 1);
+	testRingQueue(check, 4, 4);
+	return check.failed();
+}
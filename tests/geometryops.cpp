@@ -0,0 +1,192 @@
+#include "check.h"
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "sdlpp/geometryops.h"
+#include "sdlpp/pixelops.h"
+
+// the batch operations must give exactly the results of the scalar ones in
+// geometry.h, on every instruction set
+namespace
+{
+namespace Ops = SDL::GeometryOps;
+using SDL::PixelOps::Isa;
+
+// empty, shorter than a vector, and not a multiple of the 4 or 8 lane width
+constexpr std::size_t lengths[] = {0, 1, 3, 4, 5, 7, 8, 9, 15, 16, 17, 31, 33, 100, 1001};
+
+constexpr SDL::Alignment alignments[] = {
+	SDL::Alignment::TopLeft, SDL::Alignment::TopCenter, SDL::Alignment::TopRight,
+	SDL::Alignment::MiddleLeft, SDL::Alignment::MiddleCenter, SDL::Alignment::MiddleRight,
+	SDL::Alignment::BottomLeft, SDL::Alignment::BottomCenter, SDL::Alignment::BottomRight,
+};
+
+// areas and points to test against, including empty and negative sizes
+constexpr SDL::Rect areas[] = {
+	{{-500, -300}, {1000, 600}},
+	{{0, 0}, {1, 1}},
+	{{10, 10}, {0, 40}},
+	{{10, 10}, {40, 0}},
+	{{20, -20}, {-30, 50}},
+};
+
+constexpr SDL::Point points[] = {{12, -7}, {0, 0}, {-500, -300}, {499, 299}, {500, 300}};
+
+char const* isaName(Isa isa)
+{
+	switch (isa)
+	{
+		case Isa::Scalar: return "scalar";
+		case Isa::SSE2: return "sse2";
+		case Isa::AVX2: return "avx2";
+	}
+	return "unknown";
+}
+
+struct Data
+{
+	std::vector<SDL::Rect> rects;
+	std::vector<SDL::Point> points;
+	Ops::RectArray rectArray;
+	Ops::PointArray pointArray;
+};
+
+Data generate(std::size_t count, std::mt19937& rng)
+{
+	// mostly small rects around the areas, with zero and negative sizes
+	std::uniform_int_distribution<int> pos{-600, 600};
+	std::uniform_int_distribution<int> size{-8, 400};
+	Data d;
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		SDL::Rect r{{pos(rng), pos(rng)}, {size(rng), size(rng)}};
+		if (i % 7 == 0)
+		{
+			r.s.w = 0;
+		}
+		SDL::Point p{pos(rng), pos(rng)};
+		d.rects.push_back(r);
+		d.points.push_back(p);
+		d.rectArray.push_back(r);
+		d.pointArray.push_back(p);
+	}
+	return d;
+}
+
+void testOperations(Test::Check& check, Data const& d, std::string const& at)
+{
+	auto count = d.rects.size();
+	Ops::RectArray rectOut;
+	rectOut.resize(count);
+	Ops::PointArray pointOut;
+	pointOut.resize(count);
+	std::vector<std::uint8_t> mask(count);
+
+	for (auto align: alignments)
+	{
+		Ops::alignRects(d.rectArray, align, rectOut);
+		Ops::alignedPoints(d.rectArray, align, pointOut);
+		auto aligned = true;
+		auto alignedPoints = true;
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			aligned = aligned and rectOut[i] == SDL::Rect{d.rects[i].p, d.rects[i].s, align};
+			alignedPoints = alignedPoints and pointOut[i] == d.rects[i].alignedPoint(align);
+		}
+		check.expect(aligned, "alignRects" + at);
+		check.expect(alignedPoints, "alignedPoints" + at);
+
+		// in place
+		auto inPlace = d.rectArray;
+		Ops::alignRects(inPlace, align, inPlace);
+		check.expect(inPlace.x == rectOut.x and inPlace.y == rectOut.y and inPlace.w == rectOut.w and inPlace.h == rectOut.h,
+			"alignRects in place" + at);
+	}
+
+	for (auto area: areas)
+	{
+		std::size_t expected = 0;
+		auto found = Ops::containsPoints(area, d.pointArray, mask);
+		auto same = true;
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			auto in = d.points[i].in(area);
+			expected += in;
+			same = same and (mask[i] != 0) == in;
+		}
+		check.expect(same and found == expected, "containsPoints" + at);
+
+		expected = 0;
+		found = Ops::intersectRects(d.rectArray, area, mask);
+		same = true;
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			auto hit = d.rects[i].intersects(area);
+			expected += hit;
+			same = same and (mask[i] != 0) == hit;
+		}
+		check.expect(same and found == expected, "intersectRects" + at);
+
+		Ops::clipRects(d.rectArray, area, rectOut);
+		same = true;
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			same = same and rectOut[i] == d.rects[i].clipped(area);
+		}
+		check.expect(same, "clipRects" + at);
+
+		auto inPlace = d.rectArray;
+		Ops::clipRects(inPlace, area, inPlace);
+		check.expect(inPlace.x == rectOut.x and inPlace.y == rectOut.y and inPlace.w == rectOut.w and inPlace.h == rectOut.h,
+			"clipRects in place" + at);
+	}
+
+	for (auto p: points)
+	{
+		std::size_t expected = 0;
+		auto found = Ops::rectsContaining(d.rectArray, p, mask);
+		auto same = true;
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			auto in = p.in(d.rects[i]);
+			expected += in;
+			same = same and (mask[i] != 0) == in;
+		}
+		check.expect(same and found == expected, "rectsContaining" + at);
+	}
+
+	SDL::Rect bounds{{0, 0}, {0, 0}};
+	for (auto const& r: d.rects)
+	{
+		bounds = bounds.united(r);
+	}
+	check.expect(Ops::unionBounds(d.rectArray) == bounds, "unionBounds" + at);
+}
+}
+
+int main()
+{
+	Test::Check check;
+	auto supported = SDL::PixelOps::supportedIsa();
+	for (auto isa: {Isa::Scalar, Isa::SSE2, Isa::AVX2})
+	{
+		if (isa > supported)
+		{
+			std::printf("%s: not supported by this CPU, skipped\n", isaName(isa));
+			continue;
+		}
+		SDL::PixelOps::setIsa(isa);
+		check.expect(SDL::PixelOps::activeIsa() == isa, std::string{"setIsa "} + isaName(isa));
+
+		std::mt19937 rng{11};
+		for (auto length: lengths)
+		{
+			auto data = generate(length, rng);
+			testOperations(check, data, std::string{" ("} + isaName(isa) + ", " + std::to_string(length) + " elements)");
+		}
+	}
+	SDL::PixelOps::setIsa(supported);
+	return check.failed();
+}
@@ -0,0 +1,71 @@
+// Packs files into an sdlpp archive, see include/sdlpp/archive.h
+//
+//   sdlpp-pack [--decode] <output> <file>...
+//
+// Entries are named by their path as given on the command line. With
+// --decode, images are stored already decoded so loading skips the decoder.
+
+#include <cctype>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <set>
+#include <string>
+
+#include "sdlpp/archive.h"
+#include "sdlpp/surface.h"
+
+namespace
+{
+bool isImage(std::filesystem::path const& p)
+{
+	static std::set<std::string> const extensions{".bmp", ".gif", ".jpeg", ".jpg", ".png", ".tga", ".webp"};
+	auto ext = p.extension().string();
+	for (auto& c: ext)
+	{
+		c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+	}
+	return extensions.contains(ext);
+}
+}
+
+int main(int argc, char* argv[])
+{
+	int first = 1;
+	bool decode = false;
+	if (argc > 1 and std::strcmp(argv[1], "--decode") == 0)
+	{
+		decode = true;
+		++first;
+	}
+	if (argc - first < 2)
+	{
+		std::cerr << "usage: " << argv[0] << " [--decode] <output> <file>...\n";
+		return 2;
+	}
+
+	try
+	{
+		SDL::ArchiveWriter writer;
+		for (int i = first + 1; i < argc; ++i)
+		{
+			std::filesystem::path file{argv[i]};
+			auto name = file.generic_string();
+			if (decode and isImage(file))
+			{
+				writer.addPixels(name, SDL::Surface{file});
+			}
+			else
+			{
+				writer.addFile(name, file);
+			}
+		}
+		writer.write(argv[first]);
+	}
+	catch (std::exception const& e)
+	{
+		std::cerr << argv[0] << ": " << e.what() << '\n';
+		return 1;
+	}
+	return 0;
+}